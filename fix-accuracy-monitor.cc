@@ -0,0 +1,151 @@
+#include "ns3/log.h"
+#include "fix-accuracy-monitor.h"
+#include "ns3/simulator.h"
+#include "ns3/mobility-model.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+
+namespace ns3
+{
+    NS_LOG_COMPONENT_DEFINE("FixAccuracyMonitor");
+    NS_OBJECT_ENSURE_REGISTERED(FixAccuracyMonitor);
+
+    TypeId FixAccuracyMonitor::GetTypeId()
+    {
+        static TypeId tid = TypeId("ns3::FixAccuracyMonitor")
+            .AddConstructor<FixAccuracyMonitor>()
+            .SetParent<Object>();
+        return tid;
+    }
+
+    FixAccuracyMonitor::FixAccuracyMonitor () : m_errorP50(0.5), m_errorP95(0.95), m_errorP99(0.99), m_invalidFixes(0) {}
+
+    FixAccuracyMonitor::~FixAccuracyMonitor () {}
+
+    void FixAccuracyMonitor::Setup (NodeContainer tags)
+    {
+        m_tags = tags;
+        m_accuracy.assign(tags.GetN(), TagAccuracy());
+    }
+
+    void FixAccuracyMonitor::RecordFix (uint32_t tagIndex, Point fix, Time generatedAt)
+    {
+        if (tagIndex >= m_accuracy.size()) {
+            return;
+        }
+        TagAccuracy& tag = m_accuracy[tagIndex];
+        // A NaN would poison errorSum and break the ordering the quantile markers rely on
+        if (!std::isfinite(fix.x) || !std::isfinite(fix.y)) {
+            tag.invalidFixes++;
+            m_invalidFixes++;
+            NS_LOG_WARN("Dropping non-finite fix of tag " << tagIndex);
+            return;
+        }
+        Time now = Simulator::Now();
+        Vector truth = m_tags.Get(tagIndex)->GetObject<MobilityModel>()->GetPosition();
+        double error = PointDistance(fix, Point(truth.x, truth.y));
+
+        tag.errorP50.Add(error);
+        tag.errorP95.Add(error);
+        tag.errorP99.Add(error);
+        tag.errorSum += error;
+        m_errorP50.Add(error);
+        m_errorP95.Add(error);
+        m_errorP99.Add(error);
+
+        // Copies of a fix relayed to several transmitters, or older fixes arriving late,
+        // do not make the information any fresher
+        if (tag.hasFix && generatedAt <= tag.lastGenerated) {
+            return;
+        }
+        if (!tag.hasFix) {
+            tag.hasFix = true;
+            tag.firstDelivery = now;
+        } else {
+            // The age grows linearly from its value at the last delivery until now
+            double ageBefore = (tag.lastDelivery - tag.lastGenerated).GetSeconds();
+            double ageNow = (now - tag.lastGenerated).GetSeconds();
+            tag.ageArea += (now - tag.lastDelivery).GetSeconds() * (ageBefore + ageNow) / 2;
+            tag.peakAge = std::max(tag.peakAge, now - tag.lastGenerated);
+        }
+        tag.lastDelivery = now;
+        tag.lastGenerated = generatedAt;
+    }
+
+    void FixAccuracyMonitor::AgeOfInformation (const TagAccuracy& tag, double& meanAge, Time& peakAge) const
+    {
+        Time now = Simulator::Now();
+        double ageBefore = (tag.lastDelivery - tag.lastGenerated).GetSeconds();
+        double ageNow = (now - tag.lastGenerated).GetSeconds();
+        double area = tag.ageArea + (now - tag.lastDelivery).GetSeconds() * (ageBefore + ageNow) / 2;
+        double observed = (now - tag.firstDelivery).GetSeconds();
+        meanAge = observed > 0 ? area / observed : ageNow;
+        peakAge = std::max(tag.peakAge, now - tag.lastGenerated);
+    }
+
+    bool FixAccuracyMonitor::Export (const std::string& path) const
+    {
+        std::ofstream file(path);
+        if (!file) {
+            std::cout << "Cannot write accuracy file " << path << std::endl;
+            return false;
+        }
+        file << "tag,fixes,invalidFixes,errorMeanM,errorP50M,errorP95M,errorP99M,meanAgeMs,peakAgeMs" << std::endl;
+        for (uint32_t i = 0; i < m_accuracy.size(); ++i) {
+            const TagAccuracy& tag = m_accuracy[i];
+            uint64_t fixes = tag.errorP50.GetCount();
+            double meanAge = 0.0;
+            Time peakAge = Seconds(0);
+            if (tag.hasFix) {
+                AgeOfInformation(tag, meanAge, peakAge);
+            }
+            file << i << "," << fixes << "," << tag.invalidFixes
+                 << "," << (fixes ? tag.errorSum / fixes : 0.0)
+                 << "," << tag.errorP50.Get()
+                 << "," << tag.errorP95.Get()
+                 << "," << tag.errorP99.Get()
+                 << "," << meanAge * 1000
+                 << "," << peakAge.GetMilliSeconds() << std::endl;
+        }
+        NS_LOG_INFO("Wrote accuracy of " << m_accuracy.size() << " tags to " << path);
+        return true;
+    }
+
+    uint64_t FixAccuracyMonitor::GetFixCount () const
+    {
+        return m_errorP50.GetCount();
+    }
+
+    uint64_t FixAccuracyMonitor::GetInvalidFixCount () const
+    {
+        return m_invalidFixes;
+    }
+
+    void FixAccuracyMonitor::GetErrorQuantiles (double& p50, double& p95, double& p99) const
+    {
+        p50 = m_errorP50.Get();
+        p95 = m_errorP95.Get();
+        p99 = m_errorP99.Get();
+    }
+
+    double FixAccuracyMonitor::GetMeanAge () const
+    {
+        double total = 0.0;
+        uint32_t tags = 0;
+        for (const TagAccuracy& tag : m_accuracy) {
+            if (!tag.hasFix) {
+                continue;
+            }
+            double meanAge;
+            Time peakAge;
+            AgeOfInformation(tag, meanAge, peakAge);
+            total += meanAge;
+            tags++;
+        }
+        return tags ? total / tags : 0.0;
+    }
+
+} // namespace ns3
@@ -0,0 +1,78 @@
+#ifndef FIX_ACCURACY_MONITOR_H
+#define FIX_ACCURACY_MONITOR_H
+#include "utilities.h"
+#include "p2-quantile.h"
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+#include "ns3/node-container.h"
+
+#include <string>
+#include <vector>
+
+using namespace ns3;
+namespace ns3
+{
+    // Error quantiles and age of information of the fixes of one tag
+    struct TagAccuracy
+    {
+        P2Quantile errorP50;
+        P2Quantile errorP95;
+        P2Quantile errorP99;
+        double errorSum;
+        // Fixes with a non-finite coordinate, kept out of the error statistics
+        uint64_t invalidFixes;
+        // Age of information: time since the newest delivered fix was generated
+        bool hasFix;
+        Time firstDelivery;
+        Time lastDelivery;
+        Time lastGenerated;
+        // Area under the age sawtooth in s^2, divided by the observed time for the mean age
+        double ageArea;
+        Time peakAge;
+
+        TagAccuracy()
+            : errorP50(0.5), errorP95(0.95), errorP99(0.99), errorSum(0.0), invalidFixes(0), hasFix(false),
+              firstDelivery(Seconds(0)), lastDelivery(Seconds(0)), lastGenerated(Seconds(0)),
+              ageArea(0.0), peakAge(Seconds(0)) {}
+    };
+
+    // Compares every fix a transmitter receives with the true position of the tag taken from
+    // its mobility model at that instant. Memory is constant per tag whatever the run length.
+    class FixAccuracyMonitor : public Object
+    {
+        private:
+            NodeContainer m_tags;
+            std::vector<TagAccuracy> m_accuracy;
+            // Over all tags, for the run summary
+            P2Quantile m_errorP50;
+            P2Quantile m_errorP95;
+            P2Quantile m_errorP99;
+            uint64_t m_invalidFixes;
+
+            // Mean and peak age of one tag up to now
+            void AgeOfInformation (const TagAccuracy& tag, double& meanAge, Time& peakAge) const;
+
+        public:
+            FixAccuracyMonitor ();
+            ~FixAccuracyMonitor ();
+            static TypeId GetTypeId ();
+
+            // Tag index i is the tag on tags.Get(i)
+            void Setup (NodeContainer tags);
+            // fix was generated by the tag at generatedAt and is delivered now
+            void RecordFix (uint32_t tagIndex, Point fix, Time generatedAt);
+            // One CSV row per tag: fixes, invalid fixes, error quantiles in metres, mean and peak age in ms
+            bool Export (const std::string& path) const;
+
+            uint64_t GetFixCount () const;
+            // Fixes dropped because a coordinate was NaN or infinite
+            uint64_t GetInvalidFixCount () const;
+            // Over all fixes, in metres
+            void GetErrorQuantiles (double& p50, double& p95, double& p99) const;
+            // Mean age of information over the tags that received a fix, in seconds
+            double GetMeanAge () const;
+    };
+
+} // namespace ns3
+
+#endif
@@ -0,0 +1,75 @@
+#include "fix-batch-header.h"
+
+// Serialize
+void FixBatchHeader::Serialize(ns3::Buffer::Iterator start) const {
+  start.WriteHtonU16(m_anchorId);
+  start.WriteHtonU32(m_epoch);
+  start.WriteHtonU32(m_sequence);
+  start.WriteHtonU64(static_cast<uint64_t>(m_sentAtNs));
+  start.WriteHtonU16(m_entries.size());
+  for (const FixEntry& entry : m_entries) {
+    start.WriteHtonU16(entry.tagId);
+    start.WriteU8(entry.absolute ? 1 : 0);
+    if (entry.absolute) {
+      start.WriteHtonU32(static_cast<uint32_t>(entry.x));
+      start.WriteHtonU32(static_cast<uint32_t>(entry.y));
+    } else {
+      start.WriteHtonU16(static_cast<uint16_t>(static_cast<int16_t>(entry.x)));
+      start.WriteHtonU16(static_cast<uint16_t>(static_cast<int16_t>(entry.y)));
+    }
+    start.WriteHtonU16(entry.ageMs);
+  }
+}
+
+// Deserialize
+uint32_t FixBatchHeader::Deserialize(ns3::Buffer::Iterator start) {
+  m_anchorId = start.ReadNtohU16();
+  m_epoch = start.ReadNtohU32();
+  m_sequence = start.ReadNtohU32();
+  m_sentAtNs = static_cast<int64_t>(start.ReadNtohU64());
+  uint16_t count = start.ReadNtohU16();
+  m_entries.clear();
+  m_entries.reserve(count);
+  for (uint16_t i = 0; i < count; ++i) {
+    FixEntry entry;
+    entry.tagId = start.ReadNtohU16();
+    entry.absolute = start.ReadU8() != 0;
+    if (entry.absolute) {
+      entry.x = static_cast<int32_t>(start.ReadNtohU32());
+      entry.y = static_cast<int32_t>(start.ReadNtohU32());
+    } else {
+      entry.x = static_cast<int16_t>(start.ReadNtohU16());
+      entry.y = static_cast<int16_t>(start.ReadNtohU16());
+    }
+    entry.ageMs = start.ReadNtohU16();
+    m_entries.push_back(entry);
+  }
+  return GetSerializedSize();
+}
+
+// GetSerializedSize, deltas take half the space of absolute positions
+uint32_t FixBatchHeader::GetSerializedSize() const {
+  uint32_t size = sizeof(m_anchorId) + sizeof(m_epoch) + sizeof(m_sequence) + sizeof(m_sentAtNs) + sizeof(uint16_t);
+  for (const FixEntry& entry : m_entries) {
+    size += sizeof(entry.tagId) + 1 + (entry.absolute ? 8 : 4) + sizeof(entry.ageMs);
+  }
+  return size;
+}
+
+// Print
+void FixBatchHeader::Print(std::ostream &os) const {
+  os << "Anchor: " << m_anchorId << ", Epoch: " << m_epoch << ", Sequence: " << m_sequence << ", Fixes: " << m_entries.size();
+}
+
+// TypeId
+ns3::TypeId FixBatchHeader::GetTypeId(void) {
+  static ns3::TypeId tid = ns3::TypeId("FixBatchHeader")
+    .SetParent<Header>()
+    .AddConstructor<FixBatchHeader>();
+  return tid;
+}
+
+ns3::TypeId FixBatchHeader::GetInstanceTypeId(void) const
+{
+  return GetTypeId();
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "ns3/header.h"
+#include "ns3/nstime.h"
+
+#include <vector>
+
+// One tag fix inside a batch. Positions are in centimetres, either absolute or as the change
+// since the last fix this anchor sent for the same tag.
+struct FixEntry
+{
+    uint16_t tagId;
+    bool absolute;
+    int32_t x;
+    int32_t y;
+    // Time from the location request, or the generation of a relayed fix, to the sending of the
+    // batch, in milliseconds
+    uint16_t ageMs;
+};
+
+// Per-epoch batch of fixes sent by an anchor over the backhaul
+class FixBatchHeader : public ns3::Header
+{
+    public:
+        FixBatchHeader() : m_anchorId(0), m_epoch(0), m_sequence(0), m_sentAtNs(0) {}
+        virtual ~FixBatchHeader() {}
+
+        void SetAnchorId(uint16_t anchorId) { m_anchorId = anchorId; }
+        uint16_t GetAnchorId() const { return m_anchorId; }
+
+        void SetEpoch(uint32_t epoch) { m_epoch = epoch; }
+        uint32_t GetEpoch() const { return m_epoch; }
+
+        // Number of the batch among those sent by the anchor. Epochs without fixes send nothing,
+        // so only a gap in this number means a batch was lost.
+        void SetSequence(uint32_t sequence) { m_sequence = sequence; }
+        uint32_t GetSequence() const { return m_sequence; }
+
+        // Simulation time the anchor sent the batch at, so the server sees the backhaul transit
+        void SetSentAt(ns3::Time sentAt) { m_sentAtNs = sentAt.GetNanoSeconds(); }
+        ns3::Time GetSentAt() const { return ns3::NanoSeconds(m_sentAtNs); }
+
+        void AddEntry(const FixEntry& entry) { m_entries.push_back(entry); }
+        const std::vector<FixEntry>& GetEntries() const { return m_entries; }
+
+        // NS3 Header methods
+        virtual void Serialize(ns3::Buffer::Iterator start) const;
+        virtual uint32_t Deserialize(ns3::Buffer::Iterator start);
+        virtual uint32_t GetSerializedSize() const;
+        virtual void Print(std::ostream &os) const;
+
+        // Needed for NS3 TypeId system
+        static ns3::TypeId GetTypeId(void);
+        virtual ns3::TypeId GetInstanceTypeId(void) const;
+
+    private:
+        uint16_t m_anchorId;
+        uint32_t m_epoch;
+        uint32_t m_sequence;
+        int64_t m_sentAtNs;
+        std::vector<FixEntry> m_entries;
+};
@@ -0,0 +1,117 @@
+#include "ns3/log.h"
+#include "foot-server-app.h"
+#include "ns3/internet-module.h"
+#include "fix-batch-header.h"
+#include "ns3/simulator.h"
+
+namespace ns3
+{
+    NS_LOG_COMPONENT_DEFINE("FootServerApplication");
+    NS_OBJECT_ENSURE_REGISTERED(FootServerApplication);
+
+    TypeId FootServerApplication::GetTypeId()
+    {
+        static TypeId tid = TypeId("ns3::FootServerApplication")
+            .AddConstructor<FootServerApplication>()
+            .SetParent<Application>();
+        return tid;
+    }
+
+    FootServerApplication::FootServerApplication () : m_numTags(0) {}
+    FootServerApplication::~FootServerApplication () {}
+
+    void FootServerApplication::Setup (Inet6SocketAddress serverAddress, uint32_t numTags)
+    {
+        m_socket = Socket::CreateSocket(GetNode(), ns3::UdpSocketFactory::GetTypeId());
+        m_socket->Bind(serverAddress);
+        m_numTags = numTags;
+        m_fixes.assign(numTags, MergedFix());
+    }
+
+    const BackhaulStats& FootServerApplication::GetStats () const
+    {
+        return m_stats;
+    }
+
+    // Decodes a batch against the reference of its anchor and merges it into the tag table.
+    // When several anchors report the same tag the most recently requested fix wins.
+    void FootServerApplication::ReadIncoming (Ptr<Socket> socket)
+    {
+        Ptr<Packet> packet;
+        Address from;
+        while((packet = socket->RecvFrom(from))) {
+            m_stats.batches++;
+            m_stats.bytes += packet->GetSize();
+
+            FixBatchHeader batch;
+            packet->RemoveHeader(batch);
+            uint16_t anchorId = batch.GetAnchorId();
+            std::vector<std::pair<int32_t, int32_t>>& reference = m_anchorReference[anchorId];
+            std::vector<bool>& hasReference = m_anchorHasReference[anchorId];
+            uint32_t& nextSequence = m_anchorNextSequence[anchorId];
+            if (reference.empty()) {
+                reference.assign(m_numTags, {0, 0});
+                hasReference.assign(m_numTags, false);
+            }
+
+            // A lost batch may have carried keyframes or deltas, so no reference of this anchor
+            // can be trusted until the tag's next keyframe. Late or duplicated batches are older
+            // than the reference and are dropped.
+            uint32_t sequence = batch.GetSequence();
+            if (sequence < nextSequence) {
+                NS_LOG_INFO("Dropping stale batch " << sequence << " of anchor " << anchorId);
+                continue;
+            }
+            if (sequence > nextSequence) {
+                m_stats.lostBatches += sequence - nextSequence;
+                hasReference.assign(m_numTags, false);
+            }
+            nextSequence = sequence + 1;
+
+            // Fix ages are relative to the send time of the batch, so the latency below includes
+            // queuing and transit on the backhaul
+            Time now = Simulator::Now();
+            Time sentAt = batch.GetSentAt();
+            for (const FixEntry& entry : batch.GetEntries()) {
+                if (entry.tagId >= m_numTags) {
+                    continue;
+                }
+                if (entry.absolute) {
+                    reference[entry.tagId] = {entry.x, entry.y};
+                    hasReference[entry.tagId] = true;
+                } else if (hasReference[entry.tagId]) {
+                    reference[entry.tagId].first += entry.x;
+                    reference[entry.tagId].second += entry.y;
+                } else {
+                    m_stats.orphanDeltas++;
+                    continue;
+                }
+
+                Time fixTime = sentAt - MilliSeconds(entry.ageMs);
+                m_stats.fixes++;
+                m_stats.totalLatency += now - fixTime;
+
+                MergedFix& merged = m_fixes[entry.tagId];
+                if (!merged.valid || fixTime >= merged.fixTime) {
+                    merged.coord = Point(reference[entry.tagId].first / 100.0, reference[entry.tagId].second / 100.0);
+                    merged.fixTime = fixTime;
+                    merged.anchorId = anchorId;
+                    merged.valid = true;
+                }
+            }
+        }
+    }
+
+    void FootServerApplication::StartApplication()
+    {
+        m_socket->SetRecvCallback(MakeCallback (&FootServerApplication::ReadIncoming, this));
+    }
+
+    void FootServerApplication::StopApplication()
+    {
+        NS_LOG_INFO("Backhaul: batches " << m_stats.batches << ", bytes " << m_stats.bytes
+            << ", fixes " << m_stats.fixes << ", orphan deltas " << m_stats.orphanDeltas << ", lost batches " << m_stats.lostBatches << ", mean latency "
+            << (m_stats.fixes ? (m_stats.totalLatency / m_stats.fixes).GetMilliSeconds() : 0) << " ms");
+        m_socket->Close();
+    }
+} // namespace ns3
@@ -0,0 +1,65 @@
+#ifndef FOOT_SERVER_APPLICATION_H
+#define FOOT_SERVER_APPLICATION_H
+#include "utilities.h"
+#include "ns3/socket.h"
+#include "ns3/application.h"
+#include "ns3/nstime.h"
+
+#include <map>
+#include <vector>
+
+using namespace ns3;
+namespace ns3
+{
+    // Latest known position of a tag after merging all anchor streams
+    struct MergedFix
+    {
+        Point coord;
+        // Time at which the fix was requested by its anchor
+        Time fixTime;
+        uint16_t anchorId;
+        bool valid;
+
+        MergedFix() : fixTime(Seconds(0)), anchorId(0), valid(false) {}
+    };
+
+    struct BackhaulStats
+    {
+        uint64_t batches = 0;
+        uint64_t bytes = 0;
+        uint64_t fixes = 0;
+        // Deltas that arrived without a reference position, dropped until the next keyframe
+        uint64_t orphanDeltas = 0;
+        // Batches missing from the sequence of their anchor
+        uint64_t lostBatches = 0;
+        Time totalLatency = Seconds(0);
+    };
+
+    // Central server collecting the per-epoch fix batches of all anchors over the backhaul
+    class FootServerApplication : public Application
+    {
+        private:
+            virtual void StartApplication ();
+            virtual void StopApplication ();
+            void ReadIncoming (Ptr<Socket> socket);
+            Ptr<Socket> m_socket;
+            uint32_t m_numTags;
+            // Decoding reference of every anchor, in centimetres
+            std::map<uint16_t, std::vector<std::pair<int32_t, int32_t>>> m_anchorReference;
+            std::map<uint16_t, std::vector<bool>> m_anchorHasReference;
+            // Sequence number expected in the next batch of every anchor
+            std::map<uint16_t, uint32_t> m_anchorNextSequence;
+            std::vector<MergedFix> m_fixes;
+            BackhaulStats m_stats;
+
+        public:
+            FootServerApplication ();
+            ~FootServerApplication();
+            void Setup (Inet6SocketAddress serverAddress, uint32_t numTags);
+            const BackhaulStats& GetStats () const;
+            static TypeId GetTypeId ();
+    };
+
+} // namespace ns3
+
+#endif
@@ -0,0 +1,47 @@
+#include "foot-trace.h"
+#include "ns3/simulator.h"
+
+namespace ns3
+{
+    std::vector<TraceRecord> FootTracer::s_buffer;
+    size_t FootTracer::s_used = 0;
+    // Nothing is recorded until Configure is called
+    uint32_t FootTracer::s_mask = 0;
+    uint32_t FootTracer::s_sampleEvery = 1;
+    std::array<uint32_t, NUM_TRACE_CATEGORIES> FootTracer::s_sampleCount = {};
+    std::ofstream FootTracer::s_file;
+
+    int64_t FootTracer::NowNs ()
+    {
+        return Simulator::Now().GetNanoSeconds();
+    }
+
+    void FootTracer::Configure (const std::string& path, size_t capacity, uint32_t mask, uint32_t sampleEvery)
+    {
+        Close();
+        s_file.open(path, std::ios::out | std::ios::binary | std::ios::trunc);
+        s_buffer.assign(capacity > 0 ? capacity : 1, TraceRecord());
+        s_used = 0;
+        s_mask = s_file.is_open() ? mask : 0;
+        s_sampleEvery = sampleEvery > 0 ? sampleEvery : 1;
+        s_sampleCount.fill(0);
+    }
+
+    void FootTracer::Flush ()
+    {
+        if (s_used > 0 && s_file.is_open()) {
+            s_file.write(reinterpret_cast<const char*>(s_buffer.data()), s_used * sizeof(TraceRecord));
+        }
+        s_used = 0;
+    }
+
+    void FootTracer::Close ()
+    {
+        Flush();
+        if (s_file.is_open()) {
+            s_file.close();
+        }
+        s_mask = 0;
+    }
+
+} // namespace ns3
@@ -0,0 +1,78 @@
+#ifndef FOOT_TRACE_H
+#define FOOT_TRACE_H
+
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Structured event tracing for the hot paths. Build with -DFOOTSIM_TRACE to enable;
+// without it FOOT_TRACE expands to nothing and its arguments are never evaluated.
+#ifdef FOOTSIM_TRACE
+#define FOOT_TRACE(category, event, nodeId, a, b) ns3::FootTracer::Record(category, event, nodeId, a, b)
+#else
+#define FOOT_TRACE(category, event, nodeId, a, b) do {} while (false)
+#endif
+
+namespace ns3
+{
+    // Meaning of (event, a, b) per category
+    enum TraceCategory {
+        TRACE_POLL = 0,         // tag class, tag index, outstanding requests
+        TRACE_RESPONSE = 1,     // packet type, x, y
+        TRACE_SNIFF = 2,        // 0, signal in dBm, packet size
+        TRACE_SHED = 3,         // tag class, tag index, outstanding requests
+        TRACE_BACKHAUL = 4,     // epoch, fixes in batch, batch size in bytes
+        NUM_TRACE_CATEGORIES = 5
+    };
+
+    // Fixed-size binary record, written to the trace file as is
+    struct TraceRecord
+    {
+        int64_t timeNs;
+        uint32_t nodeId;
+        uint16_t category;
+        uint16_t event;
+        double a;
+        double b;
+    };
+
+    // Collects records into a buffer allocated once per run and writes it out in bulk
+    // whenever it fills up and at the end of the run
+    class FootTracer
+    {
+        private:
+            static std::vector<TraceRecord> s_buffer;
+            static size_t s_used;
+            static uint32_t s_mask;
+            static uint32_t s_sampleEvery;
+            static std::array<uint32_t, NUM_TRACE_CATEGORIES> s_sampleCount;
+            static std::ofstream s_file;
+            static int64_t NowNs ();
+
+        public:
+            // mask has one bit per TraceCategory, sampleEvery keeps one record in n per category
+            static void Configure (const std::string& path, size_t capacity, uint32_t mask, uint32_t sampleEvery);
+            static void Flush ();
+            static void Close ();
+
+            static void Record (TraceCategory category, uint16_t event, uint32_t nodeId, double a, double b)
+            {
+                if (!(s_mask & (1u << category))) {
+                    return;
+                }
+                if (++s_sampleCount[category] < s_sampleEvery) {
+                    return;
+                }
+                s_sampleCount[category] = 0;
+                s_buffer[s_used++] = {NowNs(), nodeId, static_cast<uint16_t>(category), event, a, b};
+                if (s_used == s_buffer.size()) {
+                    Flush();
+                }
+            }
+    };
+
+} // namespace ns3
+
+#endif
@@ -2,8 +2,15 @@
 #include "foot-trn-app.h"
 #include "ns3/internet-module.h"
 #include "packet-data-header.h"
+#include "fix-batch-header.h"
+#include "relay-header.h"
+#include "foot-trace.h"
 #include "ns3/simulator.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
 
 namespace ns3
 {
@@ -18,7 +25,15 @@ namespace ns3
         return tid;
     }
 
-    FootTrnApplication::FootTrnApplication () {}    
+    FootTrnApplication::FootTrnApplication ()
+        : m_pollSlot(MilliSeconds(5)), m_maxOutstanding(16), m_outstanding(0),
+          m_anchorId(0), m_epochLength(MilliSeconds(100)), m_epoch(0), m_batchSequence(0), m_keyframeInterval(10)
+    {
+        for (uint32_t c = 0; c < NUM_TAG_CLASSES; ++c) {
+            m_profiles[c] = DefaultTagClassProfile(static_cast<TagClass>(c));
+        }
+    }
+
     FootTrnApplication::~FootTrnApplication () {}
 
     void FootTrnApplication::Setup(Inet6SocketAddress sinkAddress, Point trnCoords)
@@ -28,11 +43,45 @@ namespace ns3
         m_trnLocation = trnCoords;
     }
 
-    void FootTrnApplication::ConfigurePlayerConnection (Inet6SocketAddress playerAddress)
+    void FootTrnApplication::ConfigurePlayerConnection (Inet6SocketAddress playerAddress, uint32_t nodeId, TagClass tagClass)
     {
         Ptr<Socket> playerSocket = Socket::CreateSocket(GetNode(), ns3::UdpSocketFactory::GetTypeId());
         playerSocket->Connect(playerAddress);
-        m_playerList.push_back(playerSocket);
+        playerSocket->SetPriority(m_profiles[tagClass].socketPriority);
+        m_socketIndex[playerSocket] = m_playerList.size();
+        m_nodeIndex[nodeId] = m_playerList.size();
+        m_playerList.push_back(TrackedTag(playerSocket, tagClass));
+    }
+
+    void FootTrnApplication::SetClassUpdateRate (TagClass tagClass, double updateRate)
+    {
+        m_profiles[tagClass].updateRate = updateRate;
+    }
+
+    // pollsPerSecond bounds the request rate of this transmitter, maxOutstanding is the number of
+    // unanswered requests at which the channel is considered loaded
+    void FootTrnApplication::SetPollBudget (double pollsPerSecond, uint32_t maxOutstanding)
+    {
+        if (pollsPerSecond <= 0) {
+            std::cout << "Ignoring poll budget " << pollsPerSecond << ", it must be positive" << std::endl;
+            return;
+        }
+        m_pollSlot = Seconds(1.0 / pollsPerSecond);
+        m_maxOutstanding = maxOutstanding;
+    }
+
+    // Forwards fixes to the central server once per epoch instead of once per response
+    void FootTrnApplication::ConfigureBackhaul (Inet6SocketAddress serverAddress, uint16_t anchorId, Time epochLength)
+    {
+        m_backhaulSocket = Socket::CreateSocket(GetNode(), ns3::UdpSocketFactory::GetTypeId());
+        m_backhaulSocket->Connect(serverAddress);
+        m_anchorId = anchorId;
+        m_epochLength = epochLength;
+    }
+
+    const TagClassStats& FootTrnApplication::GetClassStats (TagClass tagClass) const
+    {
+        return m_stats[tagClass];
     }
 
     void FootTrnApplication::ReadIncoming (Ptr<Socket> socket)
@@ -40,17 +89,60 @@ namespace ns3
         Ptr<Packet> packet;
         Address from;
         while((packet = socket->RecvFrom(from))) {
-            uint32_t size = packet->GetSize();
-            uint8_t buffer[size];
-            packet->CopyData(buffer, size);
-
-            PacketData incomingData;
-            std::memcpy(&incomingData, buffer, sizeof(PacketData));
-            switch (incomingData.packetType)
+            PacketDataHeader header;
+            packet->RemoveHeader(header);
+            switch (header.GetPacketType())
             {
                 case LOCATION_RESPONSE:
-                    // Write response coordinates to file
+                {
+                    auto it = m_socketIndex.find(socket);
+                    if (it != m_socketIndex.end()) {
+                        ReceiveFix(it->second, header, m_playerList[it->second].lastRequest);
+                    }
                     break;
+                }
+                case LOCATION_RELAY:
+                {
+                    // Relayed by other tags in answer to a request of this anchor
+                    RelayHeader relay;
+                    packet->RemoveHeader(relay);
+                    auto it = m_nodeIndex.find(relay.GetOriginId());
+                    if (it != m_nodeIndex.end()) {
+                        m_stats[m_playerList[it->second].tagClass].relayed++;
+                        ReceiveFix(it->second, header, relay.GetGeneratedAt());
+                    }
+                    break;
+                }
+            }
+        }
+    }
+
+    void FootTrnApplication::ReceiveFix (uint32_t tagIndex, const PacketDataHeader& header, Time fixTime)
+    {
+        FOOT_TRACE(TRACE_RESPONSE, header.GetPacketType(), GetNode()->GetId(), header.GetXCoord(), header.GetYCoord());
+        TrackedTag& tag = m_playerList[tagIndex];
+        // Latency runs from the request the fix answers, or from its generation when it arrives
+        // after the request expired
+        Time since = fixTime;
+        if (tag.awaitingResponse) {
+            tag.awaitingResponse = false;
+            m_outstanding--;
+            since = tag.lastRequest;
+        }
+        m_stats[tag.tagClass].responses++;
+        m_stats[tag.tagClass].totalLatency += Simulator::Now() - since;
+        if (m_accuracyMonitor) {
+            m_accuracyMonitor->RecordFix(tagIndex, Point(header.GetXCoord(), header.GetYCoord()), fixTime);
+        }
+        if (m_backhaulSocket) {
+            // A newer fix of the same tag replaces the pending one
+            PendingFix fix = {tagIndex, Point(header.GetXCoord(), header.GetYCoord()), fixTime};
+            int32_t& slot = m_pendingSlot[tagIndex];
+            if (slot < 0) {
+                slot = m_pendingFixes.size();
+                m_pendingFixes.push_back(fix);
+            } else {
+                m_pendingFixes[slot] = fix;
             }
         }
     }
@@ -68,48 +160,236 @@ namespace ns3
 
     }
 
-    // Function that actually retrieves player locations. Called from the main simulation code.
+    // Sends the fixes of the ending epoch as one batch. Each position is delta-encoded in
+    // centimetres against the last one sent for the same tag, the server keeps the same reference.
+    void FootTrnApplication::FlushEpoch ()
+    {
+        FixBatchHeader batch;
+        if (!m_pendingFixes.empty()) {
+            batch.SetAnchorId(m_anchorId);
+            batch.SetEpoch(m_epoch);
+            Time now = Simulator::Now();
+            batch.SetSentAt(now);
+            for (const PendingFix& fix : m_pendingFixes) {
+                m_pendingSlot[fix.tagIndex] = -1;
+                // lround is undefined for NaN and out of range values. Half the int32 range keeps
+                // the deltas below from overflowing too.
+                double cx = fix.coord.x * 100;
+                double cy = fix.coord.y * 100;
+                if (!std::isfinite(cx) || !std::isfinite(cy) || std::fabs(cx) > INT32_MAX / 2 || std::fabs(cy) > INT32_MAX / 2) {
+                    NS_LOG_WARN("Anchor " << m_anchorId << " not forwarding unencodable fix of tag " << fix.tagIndex);
+                    continue;
+                }
+                int32_t x = static_cast<int32_t>(std::lround(cx));
+                int32_t y = static_cast<int32_t>(std::lround(cy));
+                FixEntry entry;
+                entry.tagId = fix.tagIndex;
+                entry.ageMs = std::min<int64_t>((now - fix.fixTime).GetMilliSeconds(), UINT16_MAX);
+                entry.absolute = !m_hasLastSent[fix.tagIndex] || m_deltasSinceAbsolute[fix.tagIndex] >= m_keyframeInterval;
+                if (!entry.absolute) {
+                    entry.x = x - m_lastSent[fix.tagIndex].first;
+                    entry.y = y - m_lastSent[fix.tagIndex].second;
+                    entry.absolute = std::abs(entry.x) > INT16_MAX || std::abs(entry.y) > INT16_MAX;
+                }
+                if (entry.absolute) {
+                    entry.x = x;
+                    entry.y = y;
+                    m_deltasSinceAbsolute[fix.tagIndex] = 0;
+                } else {
+                    m_deltasSinceAbsolute[fix.tagIndex]++;
+                }
+                batch.AddEntry(entry);
+                m_lastSent[fix.tagIndex] = {x, y};
+                m_hasLastSent[fix.tagIndex] = true;
+            }
+            m_pendingFixes.clear();
+        }
+        if (!batch.GetEntries().empty()) {
+            batch.SetSequence(m_batchSequence++);
+
+            Ptr<Packet> batchPacket = Create<Packet>();
+            batchPacket->AddHeader(batch);
+            FOOT_TRACE(TRACE_BACKHAUL, m_epoch, GetNode()->GetId(), batch.GetEntries().size(), batchPacket->GetSize());
+            if (m_backhaulSocket->Send(batchPacket) < 0) {
+                std::cout << "Error sending epoch " << m_epoch << " from anchor " << m_anchorId << std::endl;
+            }
+        }
+        m_epoch++;
+        m_epochEvent = Simulator::Schedule(m_epochLength, &FootTrnApplication::FlushEpoch, this);
+    }
+
+    // Under load the lowest classes go first: officials once the outstanding requests reach the
+    // limit, players at twice the limit. Any tag that already missed a full period is dropped too.
+    bool FootTrnApplication::ShouldShed (const TrackedTag& tag) const
+    {
+        Time period = Seconds(1.0 / m_profiles[tag.tagClass].updateRate);
+        if (Simulator::Now() - tag.nextDue > period) {
+            return true;
+        }
+        if (tag.tagClass == TAG_OFFICIAL && m_outstanding >= m_maxOutstanding) {
+            return true;
+        }
+        return tag.tagClass == TAG_PLAYER && m_outstanding >= 2 * m_maxOutstanding;
+    }
+
+    // A request whose response has not arrived within one class period is given up, so lost
+    // packets do not count towards the channel load forever
+    void FootTrnApplication::ExpireRequests ()
+    {
+        Time now = Simulator::Now();
+        for (uint32_t c = 0; c < NUM_TAG_CLASSES; ++c) {
+            std::deque<RequestEntry>& requests = m_requests[c];
+            if (requests.empty()) {
+                continue;
+            }
+            Time period = Seconds(1.0 / m_profiles[c].updateRate);
+            while (!requests.empty() && requests.front().first + period <= now) {
+                TrackedTag& tag = m_playerList[requests.front().second];
+                // Answered requests and requests that were sent again are skipped
+                if (tag.awaitingResponse && tag.lastRequest == requests.front().first) {
+                    tag.awaitingResponse = false;
+                    m_outstanding--;
+                    m_stats[c].lost++;
+                }
+                requests.pop_front();
+            }
+        }
+    }
+
+    // Serves one request per poll slot. The highest class with a due tag wins, and within a class
+    // the tag that has been due the longest.
+    void FootTrnApplication::PollNext ()
+    {
+        Time now = Simulator::Now();
+        ExpireRequests();
+        for (uint32_t c = 0; c < NUM_TAG_CLASSES; ++c) {
+            DueQueue& queue = m_dueQueues[c];
+            while (!queue.empty() && queue.top().first <= now) {
+                uint32_t index = queue.top().second;
+                queue.pop();
+                TrackedTag& tag = m_playerList[index];
+                // Only tags of classes with a positive rate are ever queued
+                Time period = Seconds(1.0 / m_profiles[c].updateRate);
+                if (ShouldShed(tag)) {
+                    FOOT_TRACE(TRACE_SHED, c, GetNode()->GetId(), index, m_outstanding);
+                    m_stats[c].shed++;
+                    tag.nextDue = now + period;
+                    queue.push({tag.nextDue, index});
+                    continue;
+                }
+                TrackPlayerLocation(index);
+                tag.nextDue += period;
+                queue.push({tag.nextDue, index});
+                m_pollEvent = Simulator::Schedule(m_pollSlot, &FootTrnApplication::PollNext, this);
+                return;
+            }
+        }
+
+        // Nothing due, sleep until the earliest tag becomes due
+        Time next = Time::Max();
+        for (const DueQueue& queue : m_dueQueues) {
+            if (!queue.empty()) {
+                next = std::min(next, queue.top().first);
+            }
+        }
+        if (next != Time::Max()) {
+            m_pollEvent = Simulator::Schedule(std::max(next - now, m_pollSlot), &FootTrnApplication::PollNext, this);
+        }
+    }
+
+    void FootTrnApplication::SetAccuracyMonitor (Ptr<FixAccuracyMonitor> monitor)
+    {
+        m_accuracyMonitor = monitor;
+    }
+
+    // Starts the priority scheduler. Called from the main simulation code.
+    void FootTrnApplication::StartTracking ()
+    {
+        for (DueQueue& queue : m_dueQueues) {
+            queue = DueQueue();
+        }
+        for (uint32_t i = 0; i < m_playerList.size(); ++i) {
+            TrackedTag& tag = m_playerList[i];
+            if (m_profiles[tag.tagClass].updateRate <= 0) {
+                continue;
+            }
+            tag.nextDue = Simulator::Now();
+            m_dueQueues[tag.tagClass].push({tag.nextDue, i});
+        }
+        m_pollEvent.Cancel();
+        PollNext();
+    }
+
+    // Function that actually retrieves a player location
     void FootTrnApplication::TrackPlayerLocation (uint32_t playerIndex) {
-        
+
         if (playerIndex >= m_playerList.size()) {
-            playerIndex = 0;
+            return;
         }
 
-        if (!m_playerList.empty()) {
-            Ptr<Socket> playerSocket = m_playerList[playerIndex];
-            // PacketData playerInformation(LOCATION_REQUEST, m_trnLocation.x, m_trnLocation.y, -1.0);
-            // uint8_t infResBuffer[sizeof(PacketData)];
-            // std::memcpy(infResBuffer, &playerInformation, sizeof(PacketData));
-            // Ptr<Packet> outgoingPacket = Create<Packet>(infResBuffer, sizeof(PacketData));
-            NS_LOG_INFO("A");
+        TrackedTag& tag = m_playerList[playerIndex];
+        Ptr<Socket> playerSocket = tag.tagSocket;
+        // PacketData playerInformation(LOCATION_REQUEST, m_trnLocation.x, m_trnLocation.y, -1.0);
+        // uint8_t infResBuffer[sizeof(PacketData)];
+        // std::memcpy(infResBuffer, &playerInformation, sizeof(PacketData));
+        // Ptr<Packet> outgoingPacket = Create<Packet>(infResBuffer, sizeof(PacketData));
+        FOOT_TRACE(TRACE_POLL, tag.tagClass, GetNode()->GetId(), playerIndex, m_outstanding);
 
-            PacketDataHeader header;
-            header.SetPacketType(LOCATION_REQUEST);
-            header.SetXCoord(m_trnLocation.x);
-            header.SetYCoord(m_trnLocation.y);
-            header.SetBatteryLevel(-1.0);
-
-            Ptr<Packet> outgoingPacket = Create<Packet>();
-            outgoingPacket->AddHeader(header);
-            NS_LOG_INFO("Sending packet");
-            int result = playerSocket->Send(outgoingPacket);
-            if (result < 0) 
-            {
-                std::cout << "Error getting packet from player " << playerIndex << std::endl;
-            }
-            // FootTrnApplication::SendPacket(playerSocket, playerIndex);
+        PacketDataHeader header;
+        header.SetPacketType(LOCATION_REQUEST);
+        header.SetXCoord(m_trnLocation.x);
+        header.SetYCoord(m_trnLocation.y);
+        header.SetBatteryLevel(-1.0);
 
-            Simulator::Schedule(Seconds(1), &FootTrnApplication::TrackPlayerLocation, this, playerIndex + 1);
+        Ptr<Packet> outgoingPacket = Create<Packet>();
+        outgoingPacket->AddHeader(header);
+        int result = playerSocket->Send(outgoingPacket);
+        if (result < 0) 
+        {
+            std::cout << "Error getting packet from player " << playerIndex << std::endl;
+            return;
         }
+        // FootTrnApplication::SendPacket(playerSocket, playerIndex);
+
+        // An unanswered previous request is counted as lost
+        if (tag.awaitingResponse) {
+            m_stats[tag.tagClass].lost++;
+        } else {
+            m_outstanding++;
+        }
+        tag.awaitingResponse = true;
+        tag.lastRequest = Simulator::Now();
+        m_requests[tag.tagClass].push_back({tag.lastRequest, playerIndex});
+        m_stats[tag.tagClass].polls++;
     }
 
     void FootTrnApplication::StartApplication()
     {
         m_socket->SetRecvCallback(MakeCallback (&FootTrnApplication::ReadIncoming, this));
+        // Responses come back to the socket the request was sent from
+        for (TrackedTag& tag : m_playerList) {
+            tag.tagSocket->SetRecvCallback(MakeCallback (&FootTrnApplication::ReadIncoming, this));
+        }
+        if (m_backhaulSocket) {
+            m_pendingFixes.reserve(m_playerList.size());
+            m_pendingSlot.assign(m_playerList.size(), -1);
+            m_lastSent.assign(m_playerList.size(), {0, 0});
+            m_hasLastSent.assign(m_playerList.size(), false);
+            m_deltasSinceAbsolute.assign(m_playerList.size(), 0);
+            m_epochEvent = Simulator::Schedule(m_epochLength, &FootTrnApplication::FlushEpoch, this);
+        }
     }
 
     void FootTrnApplication::StopApplication()
     {
+        m_pollEvent.Cancel();
+        m_epochEvent.Cancel();
+        for (uint32_t c = 0; c < NUM_TAG_CLASSES; ++c) {
+            const TagClassStats& stats = m_stats[c];
+            NS_LOG_INFO("Class " << c << ": polls " << stats.polls << ", responses " << stats.responses
+                << ", relayed " << stats.relayed << ", shed " << stats.shed << ", lost " << stats.lost << ", mean latency "
+                << (stats.responses ? (stats.totalLatency / stats.responses).GetMilliSeconds() : 0) << " ms");
+        }
         m_socket->Close();
     }
 } // namespace ns3
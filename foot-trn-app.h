@@ -1,37 +1,130 @@
 #ifndef FOOT_TRN_APPLICATION_H
 #define FOOT_TRN_APPLICATION_H
 #include "utilities.h"
+#include "packet-data-header.h"
+#include "fix-accuracy-monitor.h"
 #include "ns3/socket.h"
 #include "ns3/application.h"
+#include "ns3/nstime.h"
+#include "ns3/event-id.h"
 
+#include <array>
+#include <deque>
+#include <functional>
+#include <map>
+#include <queue>
 #include <vector>
 
 using namespace ns3;
 namespace ns3
 {
+    // A tag polled by the transmitter and its scheduling state
+    struct TrackedTag
+    {
+        Ptr<Socket> tagSocket;
+        TagClass tagClass;
+        Time nextDue;
+        Time lastRequest;
+        bool awaitingResponse;
+
+        TrackedTag(Ptr<Socket> _tagSocket, TagClass _tagClass)
+            : tagSocket(_tagSocket), tagClass(_tagClass), nextDue(Seconds(0)), lastRequest(Seconds(0)), awaitingResponse(false) {}
+    };
+
+    // Fix received by a transmitter and waiting for the next backhaul epoch
+    struct PendingFix
+    {
+        uint32_t tagIndex;
+        Point coord;
+        // Request time, or the generation time carried by a relayed fix
+        Time fixTime;
+    };
+
+    struct TagClassStats
+    {
+        uint64_t polls = 0;
+        // Every fix received, counted once however it arrived
+        uint64_t responses = 0;
+        uint64_t shed = 0;
+        // Requests left unanswered for a full class period
+        uint64_t lost = 0;
+        // Responses that reached this transmitter over other tags
+        uint64_t relayed = 0;
+        Time totalLatency = Seconds(0);
+    };
+
     // Handles connections and methods of a single transmitter
     class FootTrnApplication : public Application
     {
         private:
-            virtual void StartApplication ();  
+            // (due time, tag index), earliest due on top
+            typedef std::pair<Time, uint32_t> DueEntry;
+            typedef std::priority_queue<DueEntry, std::vector<DueEntry>, std::greater<DueEntry>> DueQueue;
+            // (request time, tag index) in request order. The timeout of a class is its period,
+            // so each queue is also in expiry order.
+            typedef std::pair<Time, uint32_t> RequestEntry;
+
+            virtual void StartApplication ();
             virtual void StopApplication ();
             void SendPacket (Ptr<Socket> socket, uint32_t nodeIndex);
             void ReadIncoming (Ptr<Socket> socket);
+            void ReceiveFix (uint32_t tagIndex, const PacketDataHeader& header, Time fixTime);
+            void PollNext ();
+            void ExpireRequests ();
+            void FlushEpoch ();
+            bool ShouldShed (const TrackedTag& tag) const;
             Point m_trnLocation;
             Ptr<Socket> m_socket;
             Ipv6Address m_address;
             uint16_t m_port;
-            std::vector<Ptr<Socket>> m_playerList;
+            std::vector<TrackedTag> m_playerList;
+            std::map<Ptr<Socket>, uint32_t> m_socketIndex;
+            std::map<uint32_t, uint32_t> m_nodeIndex;
+            // One due queue per tag class, served in class order
+            std::array<DueQueue, NUM_TAG_CLASSES> m_dueQueues;
+            std::array<std::deque<RequestEntry>, NUM_TAG_CLASSES> m_requests;
+            std::array<TagClassProfile, NUM_TAG_CLASSES> m_profiles;
+            std::array<TagClassStats, NUM_TAG_CLASSES> m_stats;
+            // Minimum spacing between two requests of this transmitter
+            Time m_pollSlot;
+            // Unanswered requests above which lower classes are shed
+            uint32_t m_maxOutstanding;
+            uint32_t m_outstanding;
+            EventId m_pollEvent;
+            // Backhaul towards the central server, fixes are batched per epoch
+            Ptr<Socket> m_backhaulSocket;
+            uint16_t m_anchorId;
+            Time m_epochLength;
+            uint32_t m_epoch;
+            // Batches sent so far, lets the server detect lost batches
+            uint32_t m_batchSequence;
+            // After this many deltas a tag is sent as an absolute position again, so the server
+            // resynchronises after a lost batch whatever the rate of the tag
+            uint32_t m_keyframeInterval;
+            std::vector<PendingFix> m_pendingFixes;
+            std::vector<int32_t> m_pendingSlot;
+            std::vector<std::pair<int32_t, int32_t>> m_lastSent;
+            std::vector<bool> m_hasLastSent;
+            std::vector<uint32_t> m_deltasSinceAbsolute;
+            EventId m_epochEvent;
+            // Optional comparison of the fixes with the true tag positions
+            Ptr<FixAccuracyMonitor> m_accuracyMonitor;
 
         public:
             FootTrnApplication ();
             ~FootTrnApplication();
             void Setup(Inet6SocketAddress sinkAddress, Point trnCoords);
-            void ConfigurePlayerConnection (Inet6SocketAddress playerAddress);
+            void ConfigurePlayerConnection (Inet6SocketAddress playerAddress, uint32_t nodeId, TagClass tagClass = TAG_PLAYER);
+            void SetClassUpdateRate (TagClass tagClass, double updateRate);
+            void SetPollBudget (double pollsPerSecond, uint32_t maxOutstanding);
+            void ConfigureBackhaul (Inet6SocketAddress serverAddress, uint16_t anchorId, Time epochLength);
+            void SetAccuracyMonitor (Ptr<FixAccuracyMonitor> monitor);
+            void StartTracking ();
             void TrackPlayerLocation (uint32_t nodeIndex);
+            const TagClassStats& GetClassStats (TagClass tagClass) const;
             static TypeId GetTypeId ();
     };
-    
+
 } // namespace ns3
 
-#endif
\ No newline at end of file
+#endif
@@ -1,10 +1,18 @@
 #include "ns3/log.h"
+#include "ns3/assert.h"
 #include "ns3/config.h"
 #include "foot-udp-app.h"
 #include "packet-data-header.h"
+#include "foot-trace.h"
 #include "ns3/simulator.h"
 #include "ns3/wifi-net-device.h"
 #include "ns3/wifi-phy.h"
+#include "ns3/lr-wpan-net-device.h"
+#include "localization-kernels.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
 
 namespace ns3
 {
@@ -12,6 +20,20 @@ namespace ns3
     NS_LOG_COMPONENT_DEFINE("FootUdpApplication");
     NS_OBJECT_ENSURE_REGISTERED(FootUdpApplication);
 
+    // Thermal noise over the 2 MHz 802.15.4 channel plus a 5 dB receiver noise figure. The
+    // LR-WPAN PHY only reports the SINR of a frame, so the signal level rebuilt on top of this
+    // floor drops with interference and reads low under load. It is good enough to rank
+    // neighbors but would overestimate distances, so it is never used for ranging.
+    static const double LRWPAN_NOISE_FLOOR_DBM = -106.0;
+    // Default transmit powers of the Wi-Fi and LR-WPAN PHYs
+    static const double WIFI_TX_POWER_DBM = 16.0206;
+    static const double LRWPAN_TX_POWER_DBM = 0.0;
+    // Log distance range model with the defaults of LogDistancePropagationLossModel
+    static const double REFERENCE_LOSS_DB = 46.6777;
+    static const double PATH_LOSS_EXPONENT = 3.0;
+    // Neighbors used to solve a position, the fixed kernels are instantiated for this K
+    static constexpr std::size_t BEST_NEIGHBORS = 5;
+
     TypeId FootUdpApplication::GetTypeId()
     {
         static TypeId tid = TypeId("ns3::FootUdpApplication")
@@ -20,7 +42,14 @@ namespace ns3
         return tid;
     }
 
-    FootUdpApplication::FootUdpApplication () {}
+    FootUdpApplication::FootUdpApplication ()
+        : m_currentPosition(0.0, 0.0), m_batteryLevel(100.0), m_tagClass(TAG_PLAYER), m_lastSignalDbm(0.0), m_signalIsPower(false),
+          m_geoForwarding(false), m_relayRange(60.0), m_maxHops(3), m_relaySequence(0), m_seenNext(0),
+          m_beaconInterval(Seconds(1)), m_beaconFanout(4), m_beaconCursor(0),
+          m_locate(&FootUdpApplication::LocateDynamic), m_txPowerDbm(WIFI_TX_POWER_DBM), m_rangeLifetime(Seconds(2))
+    {
+        m_seenRelays.fill(UINT64_MAX);
+    }
 
     FootUdpApplication::~FootUdpApplication () {}
 
@@ -36,6 +65,22 @@ namespace ns3
         // }
     }
 
+    // Responses leave with the priority of the tag class so that the MAC can favour fast tags
+    void FootUdpApplication::SetTagClass (TagClass tagClass)
+    {
+        m_tagClass = tagClass;
+        m_socket->SetPriority(DefaultTagClassProfile(tagClass).socketPriority);
+    }
+
+    // Tags further than relayRange from the requesting anchor hand their location responses to
+    // the neighbor closest to that anchor, for at most maxHops hops
+    void FootUdpApplication::SetGeoForwarding (bool enable, double relayRange, uint8_t maxHops)
+    {
+        m_geoForwarding = enable;
+        m_relayRange = relayRange;
+        m_maxHops = maxHops;
+    }
+
     // Creates a socket to listen to packets from a player. Created for all players. 
     void FootUdpApplication::AddPlayer (Inet6SocketAddress playerAddress)
     {
@@ -43,6 +88,7 @@ namespace ns3
         Ptr<Socket> playerSocket = Socket::CreateSocket(GetNode(), tid);
         playerSocket->Connect(playerAddress);
         Neighbor n(0.0, 100.0, 0.0, playerSocket, Point(0.0, 0.0));
+        m_neighborIndex[playerSocket] = m_playerList.size();
         m_playerList.push_back(n);
     }
 
@@ -70,15 +116,16 @@ namespace ns3
 
     std::vector<Neighbor> FootUdpApplication::GetBestNeighbors () {
         std::vector<Neighbor> neighbors;
-        int numPlayers = 5;
+        int numPlayers = std::min<std::size_t>(BEST_NEIGHBORS, m_playerList.size());
         
-        std::vector<int> indices(m_playerList.size());
+        std::vector<uint32_t> indices(m_playerList.size());
         std::iota(indices.begin(), indices.end(), 0);
-        // for (int i = 0; i < m_playerList.size(); ++i) {
-        //     indices[i] = i;
-        // }
+        std::vector<double> scores(m_playerList.size());
+        for (uint32_t i = 0; i < m_playerList.size(); ++i) {
+            scores[i] = ComputeScore(m_playerList[i]);
+        }
 
-        auto comp = [this](int a, int b) { return FootUdpApplication::ComputeScore(m_playerList[a]) > FootUdpApplication::ComputeScore(m_playerList[b]); };
+        auto comp = [&scores](uint32_t a, uint32_t b) { return RanksBefore(scores[a], a, scores[b], b); };
 
         // Partially sort the vector to get the top numPlayers elements
         std::nth_element(indices.begin(), indices.begin() + numPlayers, indices.end(), comp);
@@ -87,7 +134,7 @@ namespace ns3
         std::sort(indices.begin(), indices.begin() + numPlayers, comp);
         indices.resize(numPlayers);
 
-        for (int i : indices) {
+        for (uint32_t i : indices) {
             neighbors.push_back(m_playerList[i]);
         }
         return neighbors;
@@ -104,8 +151,8 @@ namespace ns3
         double distance = sqrt((center2.x - center1.x) * (center2.x - center1.x) +
                             (center2.y - center1.y) * (center2.y - center1.y));
 
-        // Check if the circles intersect
-        if (distance > radius1 + radius2 || distance < fabs(radius1 - radius2)) {
+        // Check if the circles intersect, coincident centers would divide by zero below
+        if (distance < CIRCLE_EPSILON || distance > radius1 + radius2 || distance < fabs(radius1 - radius2)) {
             // No intersection
             return {};
         }
@@ -128,11 +175,58 @@ namespace ns3
         return intersections;
     }
 
+    // Distance to a transmitter estimated from the signal level of its request
+    double FootUdpApplication::RangeFromSignal (double signalDbm) const
+    {
+        return pow(10.0, (m_txPowerDbm - REFERENCE_LOSS_DB - signalDbm) / (10 * PATH_LOSS_EXPONENT));
+    }
+
+    bool FootUdpApplication::RangeFresh (const Transmitter& trn) const
+    {
+        return trn.range >= 0 && Simulator::Now() - trn.rangedAt <= m_rangeLifetime;
+    }
+
+    // m_currentPosition is a trilaterated fix only while every transmitter has ranged this tag
+    // recently. Until then it must not be used to route or be handed to neighbors.
+    bool FootUdpApplication::PositionKnown () const
+    {
+        for (const Transmitter& trn : m_transmitters) {
+            if (!RangeFresh(trn)) {
+                return false;
+            }
+        }
+        return !m_transmitters.empty();
+    }
+
+    // Runs the localization kernel chosen in StartApplication
     Point FootUdpApplication::GetLocation () {
+        return (this->*m_locate)();
+    }
+
+    // Dynamic pipeline for any anchor and neighbor count. Trilaterates when every transmitter
+    // has ranged this tag recently, otherwise intersects the zones of the best neighbors.
+    Point FootUdpApplication::LocateDynamic () {
+        std::vector<Point> anchors;
+        std::vector<double> ranges;
+        for (const Transmitter& trn : m_transmitters) {
+            if (!RangeFresh(trn)) {
+                break;
+            }
+            anchors.push_back(trn.coords);
+            ranges.push_back(trn.range);
+        }
+        Point anchorEstimate;
+        if (anchors.size() == m_transmitters.size() && TrilaterateN(anchors.data(), ranges.data(), anchors.size(), anchorEstimate)) {
+            return anchorEstimate;
+        }
+
         std::vector<Neighbor> closePlayers = GetBestNeighbors();
+        if (closePlayers.empty()) {
+            return m_currentPosition;
+        }
         Point currentLocation(10, 10);
 
-        int numNodes = m_playerList.size();
+        int numNodes = closePlayers.size();
 
         double delta = 0.5;
         // Create a vector of pairs (radius, index) to store the radius of each zone and its corresponding index
@@ -140,8 +234,8 @@ namespace ns3
         for (int i = 0; i < numNodes; ++i) {
             bool isPositive = isPositiveRSSD(0.0, delta);
             if (isPositive) {
-                double distance = sqrt((m_playerList[i].coord.x - m_playerList[0].coord.x) * (m_playerList[i].coord.x - m_playerList[0].coord.x) +
-                                    (m_playerList[i].coord.y - m_playerList[0].coord.y) * (m_playerList[i].coord.y - m_playerList[0].coord.y));
+                double distance = sqrt((closePlayers[i].coord.x - closePlayers[0].coord.x) * (closePlayers[i].coord.x - closePlayers[0].coord.x) +
+                                    (closePlayers[i].coord.y - closePlayers[0].coord.y) * (closePlayers[i].coord.y - closePlayers[0].coord.y));
                 zoneRadii.push_back({distance, i});
             }
         }
@@ -150,7 +244,7 @@ namespace ns3
         std::sort(zoneRadii.begin(), zoneRadii.end());
 
         // Calculate the possible zone by intersecting the smallest zones first
-        Point possibleZoneCenter = m_playerList[0].coord;
+        Point possibleZoneCenter = closePlayers[0].coord;
         double possibleZoneRadius = 0.0;
 
         for (const auto& zone : zoneRadii) {
@@ -158,7 +252,7 @@ namespace ns3
             // double distance = zone.first;
 
             // Calculate the intersection with the current zone
-            std::vector<Point> intersections = circleIntersection(possibleZoneCenter, possibleZoneRadius, m_playerList[i].coord, 0.0);
+            std::vector<Point> intersections = circleIntersection(possibleZoneCenter, possibleZoneRadius, closePlayers[i].coord, 0.0);
             if (!intersections.empty()) {
                 possibleZoneCenter = intersections[0];
                 possibleZoneRadius = 0.0;
@@ -170,6 +264,64 @@ namespace ns3
 
         return estimatedLocation;
     }
+
+    // Both kernels must produce the same fix from the same state
+    static bool SameFix (Point a, Point b) {
+        bool aFinite = std::isfinite(a.x) && std::isfinite(a.y);
+        bool bFinite = std::isfinite(b.x) && std::isfinite(b.y);
+        return aFinite == bFinite && (!aFinite || PointDistance(a, b) < 1e-9);
+    }
+
+    // Same pipeline for N transmitters and K neighbors known at compile time. All state lives
+    // in std::array on the stack and every score is computed once. Debug builds check every
+    // fix against LocateDynamic.
+    template <std::size_t N, std::size_t K>
+    Point FootUdpApplication::LocateFixed () {
+        std::array<Point, N> anchors;
+        std::array<double, N> ranges;
+        bool ranged = true;
+        for (std::size_t i = 0; i < N; ++i) {
+            ranged = ranged && RangeFresh(m_transmitters[i]);
+            anchors[i] = m_transmitters[i].coords;
+            ranges[i] = m_transmitters[i].range;
+        }
+        Point estimate;
+        if (!(ranged && Trilaterate<N>(anchors, ranges, estimate))) {
+            estimate = IntersectZonesFixed<K>();
+        }
+        NS_ASSERT_MSG(SameFix(estimate, LocateDynamic()), "Fixed-size localization kernel disagrees with LocateDynamic");
+        return estimate;
+    }
+
+    // Zone intersection over the K best neighbors, in the same order as LocateDynamic
+    template <std::size_t K>
+    Point FootUdpApplication::IntersectZonesFixed () {
+        std::array<uint32_t, K> best = SelectTopK<K>(m_playerList.size(),
+            [this](uint32_t i) { return ComputeScore(m_playerList[i]); });
+
+        double delta = 0.5;
+        // Zones are keyed by rank, so equal radii sort exactly as in LocateDynamic
+        std::array<std::pair<double, uint32_t>, K> zoneRadii;
+        std::size_t numZones = 0;
+        const Point& origin = m_playerList[best[0]].coord;
+        for (uint32_t rank = 0; rank < K; ++rank) {
+            if (isPositiveRSSD(0.0, delta)) {
+                zoneRadii[numZones++] = {PointDistance(m_playerList[best[rank]].coord, origin), rank};
+            }
+        }
+        std::sort(zoneRadii.begin(), zoneRadii.begin() + numZones);
+
+        Point possibleZoneCenter = origin;
+        double possibleZoneRadius = 0.0;
+        for (std::size_t z = 0; z < numZones; ++z) {
+            CircleHits hits = CircleIntersectionFixed(possibleZoneCenter, possibleZoneRadius, m_playerList[best[zoneRadii[z].second]].coord, 0.0);
+            if (hits.count > 0) {
+                possibleZoneCenter = hits.points[0];
+                possibleZoneRadius = 0.0;
+            }
+        }
+        return possibleZoneCenter;
+    }
     
     // Get the location of the player and send back to sink
     void FootUdpApplication::HandleRead (Ptr<Socket> socket) {
@@ -189,32 +341,160 @@ namespace ns3
             {
                 case LOCATION_REQUEST:
                 {
-                    NS_LOG_INFO("Location request");
-                    std::vector<Neighbor> closePlayers = GetBestNeighbors();
+                    // The request carries the position of the transmitter that sent it
+                    int32_t requester = -1;
+                    for (uint32_t i = 0; i < m_transmitters.size(); ++i) {
+                        Transmitter& trn = m_transmitters[i];
+                        if (trn.coords.x == header.GetXCoord() && trn.coords.y == header.GetYCoord()) {
+                            if (m_signalIsPower) {
+                                trn.range = RangeFromSignal(m_lastSignalDbm);
+                                trn.rangedAt = Simulator::Now();
+                            }
+                            requester = i;
+                        }
+                    }
+                    Point playerLocation = GetLocation();
+                    m_currentPosition = playerLocation;
+                    FOOT_TRACE(TRACE_RESPONSE, LOCATION_REQUEST, GetNode()->GetId(), playerLocation.x, playerLocation.y);
+                    PacketDataHeader response;
+                    response.SetPacketType(LOCATION_RESPONSE);
+                    response.SetXCoord(playerLocation.x);
+                    response.SetYCoord(playerLocation.y);
+                    response.SetBatteryLevel(m_batteryLevel);
+
+                    // The fix goes back to the requesting transmitter, over other tags if it is out of reach
+                    if (m_geoForwarding && requester >= 0 && PositionKnown() && PointDistance(m_currentPosition, m_transmitters[requester].coords) > m_relayRange) {
+                        RelayHeader relay;
+                        relay.SetOriginId(GetNode()->GetId());
+                        relay.SetSequence(m_relaySequence++);
+                        relay.SetHopCount(0);
+                        relay.SetAnchorIndex(requester);
+                        relay.SetPriority(DefaultTagClassProfile(m_tagClass).socketPriority);
+                        relay.SetGeneratedAt(Simulator::Now());
+                        SeenRelay(relay.GetOriginId(), relay.GetSequence());
+                        ForwardFix(response, relay);
+                        break;
+                    }
+                    Ptr<Packet> responsePacket = Create<Packet>();
+                    responsePacket->AddHeader(response);
+                    socket->SendTo(responsePacket, 0, from);
+                    break;
+                }
+                case LOCATION_RELAY:
+                {
+                    RelayHeader relay;
+                    packet->RemoveHeader(relay);
+                    if (relay.GetAnchorIndex() < m_transmitters.size() && !SeenRelay(relay.GetOriginId(), relay.GetSequence())) {
+                        ForwardFix(header, relay);
+                    }
                     break;
                 }
                 case INFO_REQUEST:
                 {
-                    PacketData playerInformation(INFO_RESPONSE, m_currentPosition.x, m_currentPosition.y, m_batteryLevel);
-                    uint8_t infResBuffer[sizeof(PacketData)];
-                    std::memcpy(infResBuffer, &playerInformation, sizeof(PacketData));
-                    Ptr<Packet> responsePacket = Create<Packet>(infResBuffer, sizeof(PacketData));
+                    if (!PositionKnown()) {
+                        break;
+                    }
+                    PacketDataHeader response;
+                    response.SetPacketType(INFO_RESPONSE);
+                    response.SetXCoord(m_currentPosition.x);
+                    response.SetYCoord(m_currentPosition.y);
+                    response.SetBatteryLevel(m_batteryLevel);
+                    Ptr<Packet> responsePacket = Create<Packet>();
+                    responsePacket->AddHeader(response);
                     socket->SendTo(responsePacket, 0, from);
                     break;
                 }
                 case INFO_RESPONSE:
                 {
-
+                    auto it = m_neighborIndex.find(socket);
+                    if (it != m_neighborIndex.end()) {
+                        Point coord(header.GetXCoord(), header.GetYCoord());
+                        m_playerList[it->second].updateAll(m_lastSignalDbm, header.GetBatteryLevel(),
+                            PointDistance(m_currentPosition, coord), coord, Simulator::Now());
+                    }
                     break;
                 }
             }
+        }
+    }
+
+    // Greedy geographic next hop: the recently located neighbor in radio range closest to the
+    // target, provided it is closer than this tag. -1 when no neighbor makes progress.
+    int32_t FootUdpApplication::NextHopTowards (Point target) const
+    {
+        int32_t best = -1;
+        double bestDistance = PointDistance(m_currentPosition, target);
+        for (uint32_t i = 0; i < m_playerList.size(); ++i) {
+            const Neighbor& neighbor = m_playerList[i];
+            // A position older than a range is as likely to be wrong as the ranges it came from
+            if (!neighbor.located || Simulator::Now() - neighbor.locatedAt > m_rangeLifetime
+                || PointDistance(m_currentPosition, neighbor.coord) > m_relayRange) {
+                continue;
+            }
+            double distance = PointDistance(neighbor.coord, target);
+            if (distance < bestDistance) {
+                best = i;
+                bestDistance = distance;
+            }
+        }
+        return best;
+    }
+
+    // Returns true if the relay was seen before, otherwise remembers it
+    bool FootUdpApplication::SeenRelay (uint32_t originId, uint32_t sequence)
+    {
+        uint64_t key = (static_cast<uint64_t>(originId) << 32) | sequence;
+        for (uint64_t seen : m_seenRelays) {
+            if (seen == key) {
+                return true;
+            }
+        }
+        m_seenRelays[m_seenNext] = key;
+        m_seenNext = (m_seenNext + 1) % m_seenRelays.size();
+        return false;
+    }
+
+    // Sends a fix one hop closer to its anchor. Once the anchor is in range, no neighbor makes
+    // progress or the hop budget is used up, it goes straight to the anchor.
+    void FootUdpApplication::ForwardFix (PacketDataHeader fix, RelayHeader relay)
+    {
+        const Transmitter& anchor = m_transmitters[relay.GetAnchorIndex()];
+        Ptr<Socket> nextHop = anchor.trnSocket;
+        if (PositionKnown() && PointDistance(m_currentPosition, anchor.coords) > m_relayRange && relay.GetHopCount() < m_maxHops) {
+            int32_t neighbor = NextHopTowards(anchor.coords);
+            if (neighbor >= 0) {
+                nextHop = m_playerList[neighbor].playerSocket;
+            }
+        }
 
-            Point playerLocation = GetLocation();
-            uint8_t sendBuffer[sizeof(Point)];
-            std::memcpy(sendBuffer, &playerLocation, sizeof(Point));
-            Ptr<Packet> response = Create<Packet>(sendBuffer, sizeof(Point));
-            socket->SendTo(response, 0, from);
+        fix.SetPacketType(LOCATION_RELAY);
+        relay.SetHopCount(relay.GetHopCount() + 1);
+        Ptr<Packet> relayPacket = Create<Packet>();
+        relayPacket->AddHeader(relay);
+        relayPacket->AddHeader(fix);
+        // The relay sockets have no priority of their own, so the MAC picks the access
+        // category of the origin tag's class from this tag
+        SocketPriorityTag priority;
+        priority.SetPriority(relay.GetPriority());
+        relayPacket->ReplacePacketTag(priority);
+        nextHop->Send(relayPacket);
+    }
+
+    // Asks the next few neighbors for their position, cycling through the whole list
+    void FootUdpApplication::RefreshNeighbors ()
+    {
+        for (uint32_t k = 0; k < m_beaconFanout && k < m_playerList.size(); ++k) {
+            const Neighbor& neighbor = m_playerList[m_beaconCursor++ % m_playerList.size()];
+            PacketDataHeader request;
+            request.SetPacketType(INFO_REQUEST);
+            request.SetXCoord(m_currentPosition.x);
+            request.SetYCoord(m_currentPosition.y);
+            request.SetBatteryLevel(m_batteryLevel);
+            Ptr<Packet> requestPacket = Create<Packet>();
+            requestPacket->AddHeader(request);
+            neighbor.playerSocket->Send(requestPacket);
         }
+        m_beaconEvent = Simulator::Schedule(m_beaconInterval, &FootUdpApplication::RefreshNeighbors, this);
     }
 
     void FootUdpApplication::SniffRx (
@@ -226,20 +506,22 @@ namespace ns3
         SignalNoiseDbm signalNoise,
         uint16_t staId) 
     {
-        // double rssi = signalNoise.signal;
-        Ptr<Packet> copyPacket = packet->Copy();
-        PacketDataHeader header;
-        copyPacket->RemoveHeader(header);
-        uint32_t size = copyPacket->GetSize();
-        NS_LOG_INFO("Sniffer");
-        if (size != sizeof(PacketData)) {
-            NS_LOG_INFO("Not trn track packet");
-        }
-        uint8_t buffer[size];
-        packet->CopyData(buffer, size);
-        PacketData incomingData;
-        std::memcpy(&incomingData, buffer, sizeof(PacketData));
-        NS_LOG_INFO(context);
+        RecordSignal(signalNoise.signal, true, packet->GetSize());
+    }
+
+    // LR-WPAN only reports the SINR of a received frame, place it above the channel noise floor
+    void FootUdpApplication::SniffLrWpanRx (std::string context, Ptr<const Packet> packet, double sinr)
+    {
+        RecordSignal(LRWPAN_NOISE_FLOOR_DBM + 10 * log10(sinr), false, packet->GetSize());
+    }
+
+    // Common receive hook of both radios. isPower is false when the level is inferred from the
+    // SINR rather than measured.
+    void FootUdpApplication::RecordSignal (double signalDbm, bool isPower, uint32_t size)
+    {
+        m_lastSignalDbm = signalDbm;
+        m_signalIsPower = isPower;
+        FOOT_TRACE(TRACE_SNIFF, 0, GetNode()->GetId(), signalDbm, size);
     }
 
     void FootUdpApplication::SetInitialPosition () {
@@ -261,16 +543,44 @@ namespace ns3
 
     void FootUdpApplication::StartApplication () {
         // FootUdpApplication::SetInitialPosition();
-        Ptr<WifiNetDevice> device = GetNode()->GetDevice(0)->GetObject<WifiNetDevice>();
-        Ptr<WifiPhy> phy = device->GetPhy();
         // NS_LOG_INFO("RSSI");
         // NS_LOG_INFO(phy->GetRxSensitivity());
         m_socket->SetRecvCallback(MakeCallback(&FootUdpApplication::HandleRead, this));
+        // Neighbors answer info requests to the socket they were asked from
+        for (Neighbor& neighbor : m_playerList) {
+            neighbor.playerSocket->SetRecvCallback(MakeCallback(&FootUdpApplication::HandleRead, this));
+        }
+        if (m_geoForwarding) {
+            m_beaconEvent = Simulator::Schedule(m_beaconInterval, &FootUdpApplication::RefreshNeighbors, this);
+        }
+        // Only this node's own radio, a wildcard path would call every app for every frame on the channel
         std::string node_id = std::to_string (GetNode ()->GetId ());
-        Config::Connect("/NodeList/*/DeviceList/0/Phy/MonitorSnifferRx", MakeCallback(&FootUdpApplication::SniffRx, this));
+        Ptr<NetDevice> radio = GetNode()->GetDevice(0);
+        if (Ptr<WifiNetDevice> device = DynamicCast<WifiNetDevice>(radio)) {
+            device->GetPhy()->TraceConnect("MonitorSnifferRx", node_id, MakeCallback(&FootUdpApplication::SniffRx, this));
+            m_txPowerDbm = WIFI_TX_POWER_DBM;
+        } else if (Ptr<LrWpanNetDevice> device = DynamicCast<LrWpanNetDevice>(radio)) {
+            device->GetPhy()->TraceConnect("PhyRxEnd", node_id, MakeCallback(&FootUdpApplication::SniffLrWpanRx, this));
+            m_txPowerDbm = LRWPAN_TX_POWER_DBM;
+        }
+
+        // Fixed-size kernels for the usual deployments, the dynamic pipeline for anything else
+        m_locate = &FootUdpApplication::LocateDynamic;
+        if (m_playerList.size() >= BEST_NEIGHBORS) {
+            switch (m_transmitters.size())
+            {
+                case 3:
+                    m_locate = &FootUdpApplication::LocateFixed<3, BEST_NEIGHBORS>;
+                    break;
+                case 4:
+                    m_locate = &FootUdpApplication::LocateFixed<4, BEST_NEIGHBORS>;
+                    break;
+            }
+        }
     }
 
     void FootUdpApplication::StopApplication () {
+        m_beaconEvent.Cancel();
         m_socket->SetRecvCallback(MakeNullCallback<void, ns3::Ptr<ns3::Socket>>());
         m_socket->Close();
     }
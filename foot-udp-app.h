@@ -1,12 +1,16 @@
 #ifndef FOOT_UDP_APPLICATION_H
 #define FOOT_UDP_APPLICATION_H
 #include "utilities.h"
+#include "packet-data-header.h"
+#include "relay-header.h"
 #include "ns3/socket.h"
 #include "ns3/applications-module.h"
 #include "ns3/wifi-tx-vector.h"
 #include "ns3/wifi-mpdu-type.h"
 #include "ns3/phy-entity.h"
 
+#include <array>
+#include <map>
 #include <vector>
 #include <numeric>
 
@@ -20,12 +24,17 @@ namespace ns3
         double distanceFromMe;
         Ptr<Socket> playerSocket;
         Point coord;
+        // Set once the neighbor has reported its position, and when it last did
+        bool located;
+        Time locatedAt;
 
         Neighbor(double _signalStrength, double _batteryLevel, double _distanceFromMe, Ptr<Socket> _playerSocket, Point _coord)
-            : oldSignalStrength(_signalStrength), batteryLevel(_batteryLevel), distanceFromMe(_distanceFromMe), playerSocket(_playerSocket), coord(_coord) {}
+            : oldSignalStrength(_signalStrength), batteryLevel(_batteryLevel), distanceFromMe(_distanceFromMe), playerSocket(_playerSocket), coord(_coord), located(false), locatedAt(Seconds(0)) {}
 
-        void updateCoord (Point newCoords) {
+        void updateCoord (Point newCoords, Time now) {
             coord = newCoords;
+            located = true;
+            locatedAt = now;
         }
 
         void updateSignalStrength (double signal) {
@@ -40,10 +49,10 @@ namespace ns3
             distanceFromMe = distance;
         }
 
-        void updateAll (double signal, double battery, double distance, Point newCoords) {
+        void updateAll (double signal, double battery, double distance, Point newCoords, Time now) {
             updateSignalStrength(signal);
             updateBatteryLevel(battery);
-            updateCoord(newCoords);
+            updateCoord(newCoords, now);
             updateDistanceFromMe(distance);
         }
     };
@@ -52,8 +61,11 @@ namespace ns3
     {
         Ptr<Socket> trnSocket;
         Point coords;
+        // Distance estimated from the signal of the last request of this transmitter, -1 if none
+        double range;
+        Time rangedAt;
 
-        Transmitter(Ptr<Socket> _trnSocket, Point _coords) : trnSocket(_trnSocket), coords(_coords) {}
+        Transmitter(Ptr<Socket> _trnSocket, Point _coords) : trnSocket(_trnSocket), coords(_coords), range(-1.0), rangedAt(Seconds(0)) {}
     };
 
     class FootUdpApplication : public ns3::Application
@@ -67,7 +79,31 @@ namespace ns3
             Point m_currentPosition;
             Point m_prevPosition;
             double m_batteryLevel;
+            TagClass m_tagClass;
+            // Signal level of the last frame received by this tag's radio
+            double m_lastSignalDbm;
+            // Whether m_lastSignalDbm is a received power the anchors can be ranged from
+            bool m_signalIsPower;
             ns3::Address m_peerAddress;
+            std::map<Ptr<Socket>, uint32_t> m_neighborIndex;
+            // Geographic forwarding of location responses towards the requesting anchor
+            bool m_geoForwarding;
+            double m_relayRange;
+            uint8_t m_maxHops;
+            uint32_t m_relaySequence;
+            // Recently relayed (origin, sequence) pairs, for duplicate suppression
+            std::array<uint64_t, 64> m_seenRelays;
+            uint32_t m_seenNext;
+            // Neighbor positions are refreshed a few neighbors at a time
+            Time m_beaconInterval;
+            uint32_t m_beaconFanout;
+            uint32_t m_beaconCursor;
+            EventId m_beaconEvent;
+            // Localization kernel, chosen at start from the anchor and neighbor counts
+            Point (FootUdpApplication::*m_locate) ();
+            double m_txPowerDbm;
+            // How long an anchor range is used for trilateration
+            Time m_rangeLifetime;
             virtual void StartApplication ();
             virtual void StopApplication ();
             double ComputeScore(const Neighbor& player);
@@ -81,7 +117,21 @@ namespace ns3
                 MpduInfo aMpdu,
                 SignalNoiseDbm signalNoise,
                 uint16_t staId);
+            void SniffLrWpanRx (std::string context, Ptr<const Packet> packet, double sinr);
+            void RecordSignal (double signalDbm, bool isPower, uint32_t size);
             Point GetLocation ();
+            Point LocateDynamic ();
+            template <std::size_t N, std::size_t K>
+            Point LocateFixed ();
+            template <std::size_t K>
+            Point IntersectZonesFixed ();
+            double RangeFromSignal (double signalDbm) const;
+            bool RangeFresh (const Transmitter& trn) const;
+            bool PositionKnown () const;
+            void RefreshNeighbors ();
+            int32_t NextHopTowards (Point target) const;
+            bool SeenRelay (uint32_t originId, uint32_t sequence);
+            void ForwardFix (PacketDataHeader fix, RelayHeader relay);
 
         public:
             FootUdpApplication();
@@ -91,6 +141,8 @@ namespace ns3
             void Setup (Inet6SocketAddress sinkAddress);
             void AddPlayer (Inet6SocketAddress playerAddress);
             void AddTransmitter (Inet6SocketAddress trnAddress, Point trnCoords);
+            void SetTagClass (TagClass tagClass);
+            void SetGeoForwarding (bool enable, double relayRange, uint8_t maxHops);
             void SetInitialPosition ();
     };
 } // namespace ns3
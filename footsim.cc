@@ -4,20 +4,26 @@
 #include "ns3/config.h"
 #include "foot-udp-app.h"
 #include "foot-trn-app.h"
+#include "foot-server-app.h"
+#include "match-mobility-generator.h"
+#include "foot-trace.h"
+#include "radio-backend.h"
+#include "fix-accuracy-monitor.h"
 #include "ns3/mobility-module.h"
 #include "ns3/netanim-module.h"
 #include "ns3/network-module.h"
 #include "ns3/energy-module.h"
 #include "ns3/internet-module.h"
+#include "ns3/csma-module.h"
 #include "ns3/lr-wpan-module.h"
 #include "ns3/sixlowpan-module.h"
 #include "ns3/ns2-mobility-helper.h"
-#include "ns3/yans-wifi-channel.h"
-#include "ns3/yans-wifi-helper.h"
 
+#include <algorithm>
 #include <fstream>
 #include <cstdlib>
 #include <iostream>
+#include <memory>
 
 using namespace ns3;
 
@@ -43,17 +49,90 @@ struct sensorValues
   double currSigStr;
 };
 
+// IPv6 packets sent by all nodes, reported for the scaling harness
+static uint64_t g_ipTxPackets = 0;
+
+static void
+CountIpTx(Ptr<const Packet> packet, Ptr<Ipv6> ipv6, uint32_t interface)
+{
+  g_ipTxPackets++;
+}
+
+// The first three transmitters sit at the middle of both goal lines and of one touchline.
+// Any further ones are spread evenly along the perimeter of the pitch.
+static std::vector<Point>
+PlaceTransmitters(uint32_t m, double xBound, double yBound)
+{
+  std::vector<Point> coords = {{0, yBound / 2}, {xBound, yBound / 2}, {xBound / 2, 0}};
+  coords.resize(std::min<uint32_t>(m, coords.size()));
+
+  double perimeter = 2 * (xBound + yBound);
+  uint32_t extra = m > 3 ? m - 3 : 0;
+  for (uint32_t k = 0; k < extra; ++k) {
+    double s = (k + 0.5) / extra * perimeter;
+    if (s < xBound) {
+      coords.push_back({s, 0});
+    } else if (s < xBound + yBound) {
+      coords.push_back({xBound, s - xBound});
+    } else if (s < 2 * xBound + yBound) {
+      coords.push_back({2 * xBound + yBound - s, yBound});
+    } else {
+      coords.push_back({0, perimeter - s});
+    }
+  }
+  return coords;
+}
+
 int 
 main(int argc, char* argv[])
 {
     // 11 players in a football team
-    LogComponentEnable ("FootSimulation", LOG_LEVEL_INFO);
-    LogComponentEnable ("FootTrnApplication", LOG_LEVEL_INFO);
-    LogComponentEnable ("FootUdpApplication", LOG_LEVEL_INFO);
-    NS_LOG_INFO ("Starting Simulation");
-
     uint32_t n = 11;
     uint32_t m = 3;
+    double duration = 15.0;
+    uint32_t seed = 1;
+    uint32_t run = 1;
+    bool enableAnim = true;
+    bool verbose = false;
+    std::string radioName = "wifi";
+
+#ifdef FOOTSIM_TRACE
+    // Binary event trace, only available in builds with -DFOOTSIM_TRACE
+    std::string eventTrace = "footsim-trace.bin";
+    uint32_t traceMask = (1u << NUM_TRACE_CATEGORIES) - 1;
+    uint32_t traceSample = 1;
+    uint32_t traceBuffer = 65536;
+#endif
+
+    // "ns2" replays a BonnMotion trace, "synthetic" generates the match in-process
+    std::string mobilityMode = "ns2";
+    std::string traceFile = "scratch/SportsSim/testscen.ns_movements";
+    MatchMobilityConfig matchConfig;
+
+    // The first numBalls tags are balls and the last numOfficials tags are referees/staff,
+    // all others are players
+    uint32_t numBalls = 0;
+    uint32_t numOfficials = 0;
+    double ballRate = DefaultTagClassProfile(TAG_BALL).updateRate;
+    double playerRate = DefaultTagClassProfile(TAG_PLAYER).updateRate;
+    double officialRate = DefaultTagClassProfile(TAG_OFFICIAL).updateRate;
+    double pollBudget = 200.0;
+    uint32_t maxOutstanding = 16;
+    uint32_t pollingAnchors = 1;
+
+    // Optional wired backhaul from the sinks to a central server
+    bool backhaul = false;
+    std::string backhaulRate = "100Mbps";
+    std::string backhaulDelay = "1ms";
+    double epochMs = 100.0;
+
+    // Geographic relaying of location responses for tags far from every anchor
+    bool geoForwarding = false;
+    double relayRange = 60.0;
+    uint32_t maxHops = 3;
+
+    // Per tag error against the true positions and age of information, off unless a file is given
+    std::string accuracyFile = "";
 
     // Dimensions of the football field are 
     // float xBound = 122; in metres, 1 metre for each goal
@@ -62,22 +141,121 @@ main(int argc, char* argv[])
     // t1 = (0,45)
     // t2 = (122, 45)
     // t3 = (61, 0)
-    std::vector<Point> trnCoords;
-
-    trnCoords.push_back({0, 45});
-    trnCoords.push_back({122, 45});
-    trnCoords.push_back({61, 0});
     CommandLine cmd(__FILE__);
-    // cmd.Parse(argc, argv);
+    cmd.AddValue("duration", "Simulated time in seconds", duration);
+    cmd.AddValue("anchors", "Number of transmitters around the pitch", m);
+    cmd.AddValue("seed", "Random number generator seed", seed);
+    cmd.AddValue("run", "Random number generator run number", run);
+    cmd.AddValue("anim", "Write the NetAnim trace footsim.xml", enableAnim);
+    cmd.AddValue("mobility", "Mobility source: ns2 or synthetic", mobilityMode);
+    cmd.AddValue("traceFile", "BonnMotion ns2 movement file used with --mobility=ns2", traceFile);
+    cmd.AddValue("teams", "Number of teams for synthetic mobility", matchConfig.numTeams);
+    cmd.AddValue("teamSize", "Players per team for synthetic mobility", matchConfig.teamSize);
+    cmd.AddValue("formation", "Formation of each team, e.g. 4-4-2", matchConfig.formation);
+    cmd.AddValue("sprintProbability", "Probability that a synthetic leg is a sprint", matchConfig.sprintProbability);
+    cmd.AddValue("sprintSpeed", "Mean sprint speed in m/s", matchConfig.sprintSpeedMean);
+    cmd.AddValue("xBound", "Pitch length in metres", matchConfig.xBound);
+    cmd.AddValue("yBound", "Pitch width in metres", matchConfig.yBound);
+    cmd.AddValue("balls", "Number of tags tracked as balls", numBalls);
+    cmd.AddValue("officials", "Number of tags tracked as referees/staff", numOfficials);
+    cmd.AddValue("ballRate", "Target ball fixes per second", ballRate);
+    cmd.AddValue("playerRate", "Target player fixes per second", playerRate);
+    cmd.AddValue("officialRate", "Target referee/staff fixes per second", officialRate);
+    cmd.AddValue("pollBudget", "Maximum location requests per second per transmitter", pollBudget);
+    cmd.AddValue("pollingAnchors", "Number of transmitters that poll the tags", pollingAnchors);
+    cmd.AddValue("maxOutstanding", "Unanswered requests at which low priority tags are shed", maxOutstanding);
+    cmd.AddValue("backhaul", "Forward fixes from the sinks to a central server", backhaul);
+    cmd.AddValue("backhaulRate", "Data rate of the CSMA backhaul", backhaulRate);
+    cmd.AddValue("backhaulDelay", "Delay of the CSMA backhaul", backhaulDelay);
+    cmd.AddValue("epoch", "Backhaul batching epoch in milliseconds", epochMs);
+    cmd.AddValue("geoForwarding", "Relay location responses over other tags towards the requesting anchor", geoForwarding);
+    cmd.AddValue("relayRange", "Distance in metres up to which a tag reaches an anchor or neighbor directly", relayRange);
+    cmd.AddValue("maxHops", "Maximum number of relay hops of a location response", maxHops);
+    cmd.AddValue("accuracyFile", "Write per tag fix error and age of information to this CSV file", accuracyFile);
+    cmd.AddValue("radio", "Tag radio: wifi (802.11ax) or lrwpan (IEEE 802.15.4)", radioName);
+    cmd.AddValue("verbose", "Enable INFO logging of the simulation components", verbose);
+#ifdef FOOTSIM_TRACE
+    cmd.AddValue("eventTrace", "Binary event trace output file", eventTrace);
+    cmd.AddValue("traceMask", "Enabled trace categories, one bit per TraceCategory", traceMask);
+    cmd.AddValue("traceSample", "Keep one trace record in this many per category", traceSample);
+    cmd.AddValue("traceBuffer", "Trace records buffered between writes", traceBuffer);
+#endif
+    cmd.Parse(argc, argv);
+
+    if (verbose) {
+      LogComponentEnable ("FootSimulation", LOG_LEVEL_INFO);
+      LogComponentEnable ("FootTrnApplication", LOG_LEVEL_INFO);
+      LogComponentEnable ("FootUdpApplication", LOG_LEVEL_INFO);
+      LogComponentEnable ("FootServerApplication", LOG_LEVEL_INFO);
+    }
+    NS_LOG_INFO ("Starting Simulation");
+
+    RadioType radioType;
+    if (!RadioBackend::ParseRadioType(radioName, radioType)) {
+      std::cerr << "Unknown radio " << radioName << ", expected wifi or lrwpan" << std::endl;
+      return 1;
+    }
+    if (backhaul && epochMs <= 0) {
+      std::cerr << "epoch must be positive" << std::endl;
+      return 1;
+    }
+    // Tags only know where they are once every anchor ranges them, which geographic
+    // forwarding relies on
+    if (geoForwarding && radioType == RADIO_LRWPAN) {
+      std::cerr << "geoForwarding needs the wifi radio, LR-WPAN tags cannot range the anchors" << std::endl;
+      return 1;
+    }
+    // Without ranges every LR-WPAN fix is a neighbor fallback, there is no localization to measure
+    if (!accuracyFile.empty() && radioType == RADIO_LRWPAN) {
+      std::cerr << "accuracyFile needs the wifi radio, LR-WPAN fixes are not ranged" << std::endl;
+      return 1;
+    }
+    if (geoForwarding && pollingAnchors < m) {
+      std::cerr << "geoForwarding needs --pollingAnchors=" << m << " so that tags can trilaterate" << std::endl;
+      return 1;
+    }
+    // Relay headers carry the hop count and the requesting anchor in one byte each
+    if (geoForwarding && maxHops > UINT8_MAX) {
+      std::cerr << "maxHops must be at most " << UINT8_MAX << std::endl;
+      return 1;
+    }
+    if (geoForwarding && m > UINT8_MAX) {
+      std::cerr << "geoForwarding supports at most " << UINT8_MAX << " anchors" << std::endl;
+      return 1;
+    }
+    if (pollBudget <= 0) {
+      std::cerr << "pollBudget must be positive" << std::endl;
+      return 1;
+    }
+#ifdef FOOTSIM_TRACE
+    FootTracer::Configure(eventTrace, traceBuffer, traceMask, traceSample);
+#endif
     // Time::SetResolution(Time::S);
 
+    RngSeedManager::SetSeed(seed);
+    RngSeedManager::SetRun(run);
+
+    std::vector<Point> trnCoords = PlaceTransmitters(m, matchConfig.xBound, matchConfig.yBound);
+
+    Ptr<MatchMobilityGenerator> matchMobility;
+    if (mobilityMode == "synthetic") {
+        matchMobility = CreateObject<MatchMobilityGenerator>();
+        matchMobility->Setup(matchConfig);
+        n = matchMobility->GetNumPlayers();
+    }
+
     // Player nodes are first n nodes
     NodeContainer playerNodes;
     playerNodes.Create(n);
 
-    // Using mobility model generated from BonnMotion
-    Ns2MobilityHelper ns2 = Ns2MobilityHelper("scratch/SportsSim/testscen.ns_movements");
-    ns2.Install();
+    if (matchMobility) {
+        matchMobility->AssignStreams(0);
+        matchMobility->Install(playerNodes);
+    } else {
+        // Using mobility model generated from BonnMotion
+        Ns2MobilityHelper ns2 = Ns2MobilityHelper(traceFile);
+        ns2.Install();
+    }
 
     NodeContainer sinks;
     sinks.Create(m);
@@ -86,14 +264,21 @@ main(int argc, char* argv[])
     mobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
 
     Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator>();
-    positionAlloc->Add(Vector(trnCoords[0].x, trnCoords[0].y, 0.0));
-    positionAlloc->Add(Vector(trnCoords[1].x, trnCoords[1].y, 0.0));
-    positionAlloc->Add(Vector(trnCoords[2].x, trnCoords[2].y, 0.0));
+    for (const Point& trn : trnCoords) {
+      positionAlloc->Add(Vector(trn.x, trn.y, 0.0));
+    }
     mobility.SetPositionAllocator(positionAlloc);
     mobility.Install(sinks);
 
     NodeContainer allNodes = NodeContainer(playerNodes, sinks);
 
+    auto tagClassOf = [n, numBalls, numOfficials](uint32_t index) {
+        if (index < numBalls) {
+            return TAG_BALL;
+        }
+        return index + numOfficials >= n ? TAG_OFFICIAL : TAG_PLAYER;
+    };
+
     // Adding point to point connections between the sinks and all the players
     // PointToPointHelper p2p;
     // p2p.SetDeviceAttribute("DataRate", StringValue("5Mbps"));
@@ -101,43 +286,22 @@ main(int argc, char* argv[])
 
     // NetDeviceContainer sink0Devices;
     // NetDeviceContainer sink1Devicmodule
-    // Creating a wifi channel between all the nodes(Sinks+players)
-    WifiHelper wifi;
-    wifi.SetStandard(WIFI_STANDARD_80211ax);
-
-    YansWifiPhyHelper wifiPhy;
-
-    Ptr<YansWifiChannel> wifiChannel = CreateObject<YansWifiChannel>();
-    Ptr<LogDistancePropagationLossModel> lossModel =
-        CreateObject<LogDistancePropagationLossModel>();
-    Ptr<ConstantSpeedPropagationDelayModel> delayModel = CreateObject<ConstantSpeedPropagationDelayModel>();
-
-    wifiChannel->SetPropagationDelayModel(delayModel);
-    wifiChannel->SetPropagationLossModel(lossModel);
-
-    // wifiChannel.AddPropagationLoss("ns3::LogDistancePropagationLossModel");
-    // wifiChannel.SetPropagationDelay("ns3::ConstantSpeedPropagationDelayModel");
-    
-    wifiPhy.SetChannel(wifiChannel);
-  
-    WifiMacHelper wifiMac;
-    wifi.SetRemoteStationManager("ns3::ConstantRateWifiManager");
-    // Set it to adhoc mode
-    wifiMac.SetType("ns3::AdhocWifiMac");
-    
-    NetDeviceContainer devices = wifi.Install(wifiPhy, wifiMac, allNodes);
-
-    // // Setting up LRWPAN for players on the field and transmitters
-    // LrWpanHelper lrWpanHelper;
-    // NetDeviceContainer lrwpanDevices = lrWpanHelper.Install(devices);
-
-    // lrWpanHelper.CreateAssociatedPan(lrwpanDevices, 10);
-    // std::cout << "Created " << lrwpanDeices.GetN() << " devices" << std::endl;
-    // std::cout << "There are " << playerNodes.GetN() << " nodes" << std::endl;
+    // Radio between all the nodes(Sinks+players), Wi-Fi or LR-WPAN with 6LoWPAN on top
+    Ptr<RadioBackend> radio = CreateObject<RadioBackend>();
+    radio->Setup(radioType);
+    NetDeviceContainer devices = radio->Install(allNodes);
+
+    // Only the tags run on batteries
+    NetDeviceContainer tagDevices;
+    for (uint32_t i = 0; i < n; ++i) {
+      tagDevices.Add(devices.Get(i));
+    }
+    radio->MeterEnergy(tagDevices);
 
     InternetStackHelper internetv6;
     internetv6.SetIpv4StackInstall(false);
     internetv6.Install(allNodes);
+    Config::ConnectWithoutContext("/NodeList/*/$ns3::Ipv6L3Protocol/Tx", MakeCallback(&CountIpTx));
 
     SixLowPanHelper sixLowPanHelper;
     NetDeviceContainer sixLowPanDevices = sixLowPanHelper.Install(devices);
@@ -152,6 +316,42 @@ main(int argc, char* argv[])
     // Common port number for all nodes
     uint16_t port = 50000;
 
+    // Wired backhaul: the sinks and the server share one CSMA segment on a separate prefix
+    Ptr<Node> serverNode;
+    Ptr<FootServerApplication> serverApp;
+    Inet6SocketAddress serverAddress(Ipv6Address::GetAny(), port);
+    if (backhaul) {
+      serverNode = CreateObject<Node>();
+      NodeContainer backhaulNodes = NodeContainer(sinks, NodeContainer(serverNode));
+      internetv6.Install(serverNode);
+      // Off the pitch, behind the middle of the touchline
+      Ptr<ConstantPositionMobilityModel> serverPosition = CreateObject<ConstantPositionMobilityModel>();
+      serverPosition->SetPosition(Vector(matchConfig.xBound / 2, -10.0, 0.0));
+      serverNode->AggregateObject(serverPosition);
+
+      CsmaHelper csma;
+      csma.SetChannelAttribute("DataRate", StringValue(backhaulRate));
+      csma.SetChannelAttribute("Delay", StringValue(backhaulDelay));
+      NetDeviceContainer backhaulDevices = csma.Install(backhaulNodes);
+
+      Ipv6AddressHelper backhaulIpv6;
+      backhaulIpv6.SetBase(Ipv6Address("2001:f00d::"), Ipv6Prefix(64));
+      Ipv6InterfaceContainer backhaulInterfaces = backhaulIpv6.Assign(backhaulDevices);
+      serverAddress = Inet6SocketAddress(backhaulInterfaces.GetAddress(m, 1), port);
+
+      serverApp = CreateObject<FootServerApplication>();
+      serverNode->AddApplication(serverApp);
+      serverApp->Setup(serverAddress, n);
+      serverApp->SetStartTime(Seconds(0.0));
+      serverApp->SetStopTime(Seconds(duration));
+    }
+
+    Ptr<FixAccuracyMonitor> accuracyMonitor;
+    if (!accuracyFile.empty()) {
+      accuracyMonitor = CreateObject<FixAccuracyMonitor>();
+      accuracyMonitor->Setup(playerNodes);
+    }
+
     ApplicationContainer sinkApps;
     ApplicationContainer playerApps;
 
@@ -160,19 +360,30 @@ main(int argc, char* argv[])
       Ptr<Node> sinkNode = sinks.Get(i);
       Ptr<FootTrnApplication> app_j = CreateObject<FootTrnApplication>();
       sinkNode->AddApplication(app_j);
-      Inet6SocketAddress sinkAddress(wsnDeviceInterfaces.GetAddress(i+n, 0), port);
+      // Global address, the one the players send to
+      Inet6SocketAddress sinkAddress(wsnDeviceInterfaces.GetAddress(i+n, 1), port);
       app_j->Setup(sinkAddress, trnCoords[i]);
+      app_j->SetClassUpdateRate(TAG_BALL, ballRate);
+      app_j->SetClassUpdateRate(TAG_PLAYER, playerRate);
+      app_j->SetClassUpdateRate(TAG_OFFICIAL, officialRate);
+      app_j->SetPollBudget(pollBudget, maxOutstanding);
+      if (backhaul) {
+        app_j->ConfigureBackhaul(serverAddress, i, Seconds(epochMs / 1000));
+      }
+      if (accuracyMonitor) {
+        app_j->SetAccuracyMonitor(accuracyMonitor);
+      }
       for (uint32_t j = 0; j < n; ++j) {
         Ptr<Node> wsnNode = playerNodes.Get(j);
         Inet6SocketAddress playerAddress(wsnDeviceInterfaces.GetAddress(j, 1), port);
-        app_j->ConfigurePlayerConnection(playerAddress);
+        app_j->ConfigurePlayerConnection(playerAddress, wsnNode->GetId(), tagClassOf(j));
         // std::cout << "Created player " << j << " connection for sink " << i << std::endl;
       }
       sinkApps.Add(app_j);
     }
     
     sinkApps.Start(Seconds(0.0));
-    sinkApps.Stop(Seconds(15.0));
+    sinkApps.Stop(Seconds(duration));
 
     // uDP connections player->player and player->sink
     for(uint32_t i = 0; i < n; ++i) {
@@ -181,8 +392,10 @@ main(int argc, char* argv[])
       wsnNode->AddApplication(app_i);
       Inet6SocketAddress selfAddress(wsnDeviceInterfaces.GetAddress(i, 1), port);
       app_i->Setup(selfAddress);
+      app_i->SetTagClass(tagClassOf(i));
+      app_i->SetGeoForwarding(geoForwarding, relayRange, maxHops);
       // Player->player  
-      for (uint32_t j = 1; j < n; ++j) {
+      for (uint32_t j = 0; j < n; ++j) {
         if (i != j){
           Inet6SocketAddress playerAddress(wsnDeviceInterfaces.GetAddress(j, 1), port);
           app_i->AddPlayer(playerAddress);
@@ -199,21 +412,74 @@ main(int argc, char* argv[])
     }
 
     playerApps.Start(Seconds(0.0));
-    playerApps.Stop(Seconds(15.0));
+    playerApps.Stop(Seconds(duration));
     NS_LOG_INFO("Players added");
 
-    // Recursively getting the player locations from a single transmitter. For now. 
-    Ptr<Node> transmitter1 = sinks.Get(0);
-    Ptr<Application> app = transmitter1->GetApplication(0);
-    Ptr<FootTrnApplication> trnApplication = DynamicCast<FootTrnApplication>(app);
-    Simulator::Schedule(Seconds(1), &FootTrnApplication::TrackPlayerLocation, trnApplication, 0);
+    // Polling the player locations through the priority scheduler of the first pollingAnchors
+    // transmitters. Tags trilaterate once every transmitter has ranged them.
+    for (uint32_t i = 0; i < std::min(pollingAnchors, m); ++i) {
+      Ptr<FootTrnApplication> trnApplication = DynamicCast<FootTrnApplication>(sinks.Get(i)->GetApplication(0));
+      Simulator::Schedule(Seconds(1), &FootTrnApplication::StartTracking, trnApplication);
+    }
 
-    Simulator::Stop(Seconds(15.0));
-    std::cout << "Creating trace XML file" << std::endl;
-    AnimationInterface anim("footsim.xml");
-    anim.EnablePacketMetadata(true);
+    Simulator::Stop(Seconds(duration));
+    // NetAnim keeps per-packet metadata for the whole run, large scenarios switch it off
+    std::unique_ptr<AnimationInterface> anim;
+    if (enableAnim) {
+      std::cout << "Creating trace XML file" << std::endl;
+      anim.reset(new AnimationInterface("footsim.xml"));
+      anim->EnablePacketMetadata(true);
+    }
     Simulator::Run();
 
+    // Fixes delivered to the transmitters, for comparing radios per fix
+    uint64_t fixes = 0;
+    Time fixLatency = Seconds(0);
+    for (uint32_t i = 0; i < m; ++i) {
+      Ptr<FootTrnApplication> sinkApp = DynamicCast<FootTrnApplication>(sinkApps.Get(i));
+      for (uint32_t c = 0; c < NUM_TAG_CLASSES; ++c) {
+        fixes += sinkApp->GetClassStats(static_cast<TagClass>(c)).responses;
+        fixLatency += sinkApp->GetClassStats(static_cast<TagClass>(c)).totalLatency;
+      }
+    }
+    double tagEnergy = radio->GetTotalEnergy();
+
+    // Single line summary parsed by scaling-harness.py
+    std::cout << "footsim-stats players=" << n << " anchors=" << m
+              << " radio=" << radioName
+              << " simSeconds=" << duration
+              << " events=" << Simulator::GetEventCount()
+              << " packets=" << g_ipTxPackets
+              << " fixes=" << fixes
+              << " fixLatencyMs=" << (fixes ? fixLatency.GetMilliSeconds() / static_cast<double>(fixes) : 0.0)
+              << " tagEnergyJ=" << tagEnergy
+              << " energyPerFixJ=" << (fixes ? tagEnergy / fixes : 0.0);
+    if (serverApp) {
+      const BackhaulStats& backhaulStats = serverApp->GetStats();
+      std::cout << " backhaulBytes=" << backhaulStats.bytes
+                << " backhaulBatches=" << backhaulStats.batches
+                << " backhaulLatencyMs=" << (backhaulStats.fixes ? backhaulStats.totalLatency.GetMilliSeconds() / static_cast<double>(backhaulStats.fixes) : 0.0)
+                << " backhaulLostBatches=" << backhaulStats.lostBatches
+                << " backhaulOrphanDeltas=" << backhaulStats.orphanDeltas;
+    }
+    if (accuracyMonitor) {
+      double errorP50, errorP95, errorP99;
+      accuracyMonitor->GetErrorQuantiles(errorP50, errorP95, errorP99);
+      std::cout << " errorP50M=" << errorP50
+                << " errorP95M=" << errorP95
+                << " errorP99M=" << errorP99
+                << " meanAgeMs=" << accuracyMonitor->GetMeanAge() * 1000
+                << " invalidFixes=" << accuracyMonitor->GetInvalidFixCount();
+    }
+    std::cout << std::endl;
+    if (accuracyMonitor) {
+      accuracyMonitor->Export(accuracyFile);
+    }
+
+    anim.reset();
+#ifdef FOOTSIM_TRACE
+    FootTracer::Close();
+#endif
     Simulator::Destroy();
 
     return 0;
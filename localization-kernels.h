@@ -0,0 +1,135 @@
+#ifndef LOCALIZATION_KERNELS_H
+#define LOCALIZATION_KERNELS_H
+#include "utilities.h"
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+// Allocation-free building blocks of the localization pipeline. The templated variants take
+// the anchor count and the neighbor count K as compile-time constants so that all storage is
+// std::array and the loops are unrolled; FootUdpApplication picks them at setup time.
+namespace ns3
+{
+    // Centers closer than this are treated as coincident
+    static const double CIRCLE_EPSILON = 1e-9;
+
+    // Zero, one or two intersection points of two circles
+    struct CircleHits
+    {
+        uint32_t count;
+        std::array<Point, 2> points;
+    };
+
+    inline CircleHits CircleIntersectionFixed(Point center1, double radius1, Point center2, double radius2) {
+        CircleHits hits;
+        hits.count = 0;
+        double distance = sqrt((center2.x - center1.x) * (center2.x - center1.x) +
+                            (center2.y - center1.y) * (center2.y - center1.y));
+
+        // Concentric circles have no intersection points, and every division below is by distance
+        if (distance < CIRCLE_EPSILON || distance > radius1 + radius2 || distance < fabs(radius1 - radius2)) {
+            return hits;
+        }
+
+        double a = (radius1 * radius1 - radius2 * radius2 + distance * distance) / (2 * distance);
+        double h = sqrt(radius1 * radius1 - a * a);
+        double x2 = center1.x + a * (center2.x - center1.x) / distance;
+        double y2 = center1.y + a * (center2.y - center1.y) / distance;
+
+        hits.points[0] = Point(x2 + h * (center2.y - center1.y) / distance, y2 - h * (center2.x - center1.x) / distance);
+        hits.points[1] = Point(x2 - h * (center2.y - center1.y) / distance, y2 + h * (center2.x - center1.x) / distance);
+        hits.count = 2;
+        return hits;
+    }
+
+    // Neighbor ranking shared by every kernel: higher score first, lower index on equal scores,
+    // so that ties (e.g. several neighbors still at distance 0) always resolve the same way
+    inline bool RanksBefore(double scoreA, uint32_t a, double scoreB, uint32_t b) {
+        return scoreA > scoreB || (scoreA == scoreB && a < b);
+    }
+
+    // Indices of the K best of count candidates in RanksBefore order. Every score is computed
+    // once and kept in a sorted top-K array. count must be at least K.
+    template <std::size_t K, typename ScoreFn>
+    std::array<uint32_t, K> SelectTopK(uint32_t count, ScoreFn score) {
+        std::array<uint32_t, K> top;
+        std::array<double, K> topScore;
+        uint32_t filled = 0;
+        for (uint32_t i = 0; i < count; ++i) {
+            double s = score(i);
+            if (filled == K && !RanksBefore(s, i, topScore[K - 1], top[K - 1])) {
+                continue;
+            }
+            uint32_t pos = filled < K ? filled++ : K - 1;
+            while (pos > 0 && RanksBefore(s, i, topScore[pos - 1], top[pos - 1])) {
+                top[pos] = top[pos - 1];
+                topScore[pos] = topScore[pos - 1];
+                --pos;
+            }
+            top[pos] = i;
+            topScore[pos] = s;
+        }
+        return top;
+    }
+
+    // Solves the 2x2 normal equations of the linearised range equations. Returns false when the
+    // anchors are collinear.
+    inline bool SolveNormalEquations(double ata00, double ata01, double ata11, double atb0, double atb1, Point& estimate) {
+        double det = ata00 * ata11 - ata01 * ata01;
+        if (fabs(det) < 1e-9) {
+            return false;
+        }
+        estimate = Point((ata11 * atb0 - ata01 * atb1) / det, (ata00 * atb1 - ata01 * atb0) / det);
+        return true;
+    }
+
+    // Linear least squares position from ranges to n >= 3 anchors, subtracting the first range
+    // equation from the others. Returns false when the anchors are collinear.
+    inline bool TrilaterateN(const Point* anchors, const double* ranges, std::size_t n, Point& estimate) {
+        if (n < 3) {
+            return false;
+        }
+        double ata00 = 0.0, ata01 = 0.0, ata11 = 0.0, atb0 = 0.0, atb1 = 0.0;
+        double base = anchors[0].x * anchors[0].x + anchors[0].y * anchors[0].y - ranges[0] * ranges[0];
+        for (std::size_t i = 1; i < n; ++i) {
+            double ax = 2 * (anchors[i].x - anchors[0].x);
+            double ay = 2 * (anchors[i].y - anchors[0].y);
+            double b = anchors[i].x * anchors[i].x + anchors[i].y * anchors[i].y - ranges[i] * ranges[i] - base;
+            ata00 += ax * ax;
+            ata01 += ax * ay;
+            ata11 += ay * ay;
+            atb0 += ax * b;
+            atb1 += ay * b;
+        }
+        return SolveNormalEquations(ata00, ata01, ata11, atb0, atb1, estimate);
+    }
+
+    // Fixed anchor count variant. The N - 1 linearised rows are built into std::array first so
+    // the accumulation runs over a compile-time extent and is unrolled and vectorised; the sums
+    // are taken in the same order as TrilaterateN so both give bit-identical estimates.
+    template <std::size_t N>
+    bool Trilaterate(const std::array<Point, N>& anchors, const std::array<double, N>& ranges, Point& estimate) {
+        static_assert(N >= 3, "Trilateration needs at least three anchors");
+        std::array<double, N - 1> ax, ay, b;
+        double base = anchors[0].x * anchors[0].x + anchors[0].y * anchors[0].y - ranges[0] * ranges[0];
+        for (std::size_t i = 1; i < N; ++i) {
+            ax[i - 1] = 2 * (anchors[i].x - anchors[0].x);
+            ay[i - 1] = 2 * (anchors[i].y - anchors[0].y);
+            b[i - 1] = anchors[i].x * anchors[i].x + anchors[i].y * anchors[i].y - ranges[i] * ranges[i] - base;
+        }
+        double ata00 = 0.0, ata01 = 0.0, ata11 = 0.0, atb0 = 0.0, atb1 = 0.0;
+        for (std::size_t r = 0; r < N - 1; ++r) {
+            ata00 += ax[r] * ax[r];
+            ata01 += ax[r] * ay[r];
+            ata11 += ay[r] * ay[r];
+            atb0 += ax[r] * b[r];
+            atb1 += ay[r] * b[r];
+        }
+        return SolveNormalEquations(ata00, ata01, ata11, atb0, atb1, estimate);
+    }
+
+} // namespace ns3
+
+#endif
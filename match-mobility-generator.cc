@@ -0,0 +1,193 @@
+#include "ns3/log.h"
+#include "match-mobility-generator.h"
+#include "ns3/simulator.h"
+#include "ns3/node.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <numeric>
+#include <sstream>
+
+namespace ns3
+{
+    NS_LOG_COMPONENT_DEFINE("MatchMobilityGenerator");
+    NS_OBJECT_ENSURE_REGISTERED(MatchMobilityGenerator);
+
+    TypeId MatchMobilityGenerator::GetTypeId()
+    {
+        static TypeId tid = TypeId("ns3::MatchMobilityGenerator")
+            .AddConstructor<MatchMobilityGenerator>()
+            .SetParent<Object>();
+        return tid;
+    }
+
+    MatchMobilityGenerator::MatchMobilityGenerator ()
+    {
+        m_uniform = CreateObject<UniformRandomVariable>();
+        m_normal = CreateObject<NormalRandomVariable>();
+    }
+
+    MatchMobilityGenerator::~MatchMobilityGenerator () {}
+
+    void MatchMobilityGenerator::Setup (const MatchMobilityConfig& config)
+    {
+        m_config = config;
+        m_focus = Point(m_config.xBound / 2, m_config.yBound / 2);
+    }
+
+    uint32_t MatchMobilityGenerator::GetNumPlayers () const
+    {
+        return m_config.numTeams * m_config.teamSize;
+    }
+
+    int64_t MatchMobilityGenerator::AssignStreams (int64_t stream)
+    {
+        m_uniform->SetStream(stream);
+        m_normal->SetStream(stream + 1);
+        return 2;
+    }
+
+    // Turns "4-4-2" into the outfield player count of each line, back to front.
+    // The counts are stretched or trimmed so that they add up to teamSize - 1.
+    std::vector<uint32_t> MatchMobilityGenerator::ParseFormation () const
+    {
+        std::vector<uint32_t> lines;
+        std::stringstream ss(m_config.formation);
+        std::string token;
+        while (std::getline(ss, token, '-')) {
+            int count = std::atoi(token.c_str());
+            if (count > 0) {
+                lines.push_back(count);
+            }
+        }
+        if (lines.empty()) {
+            lines = {4, 4, 2};
+        }
+
+        uint32_t outfield = m_config.teamSize > 0 ? m_config.teamSize - 1 : 0;
+        uint32_t total = std::accumulate(lines.begin(), lines.end(), 0u);
+        for (uint32_t i = 0; total < outfield; ++i, ++total) {
+            lines[i % lines.size()]++;
+        }
+        for (uint32_t i = lines.size(); total > outfield; ) {
+            i = (i == 0) ? lines.size() - 1 : i - 1;
+            if (lines[i] > 0) {
+                lines[i]--;
+                total--;
+            }
+        }
+        return lines;
+    }
+
+    // Home positions of one team: goalkeeper first, then each line spread evenly across the width.
+    // Team 0 defends x = 0, every other team is mirrored onto the opposite half.
+    std::vector<Point> MatchMobilityGenerator::FormationHomes (uint32_t team) const
+    {
+        std::vector<Point> homes;
+        if (m_config.teamSize == 0) {
+            return homes;
+        }
+        double length = m_config.xBound;
+        double width = m_config.yBound;
+        bool mirrored = (team % 2) == 1;
+        auto side = [length, mirrored](double x) { return mirrored ? length - x : x; };
+
+        homes.push_back({side(0.04 * length), width / 2});
+
+        std::vector<uint32_t> lines = ParseFormation();
+        for (uint32_t i = 0; i < lines.size(); ++i) {
+            double depth = lines.size() == 1 ? 0.3 : 0.15 + 0.30 * i / (lines.size() - 1);
+            for (uint32_t j = 0; j < lines[i]; ++j) {
+                homes.push_back({side(depth * length), width * (j + 1) / (lines[i] + 1)});
+            }
+        }
+        return homes;
+    }
+
+    Point MatchMobilityGenerator::ClampToPitch (Point p) const
+    {
+        return Point(std::min(std::max(p.x, 0.0), m_config.xBound),
+                     std::min(std::max(p.y, 0.0), m_config.yBound));
+    }
+
+    // Players follow the ball focus around their formation slot, with some random freedom
+    Point MatchMobilityGenerator::NextTarget (const PlayerState& player)
+    {
+        double shiftX = 0.6 * (m_focus.x - m_config.xBound / 2);
+        double shiftY = 0.3 * (m_focus.y - m_config.yBound / 2);
+        double r = m_config.jitterRadius;
+        return ClampToPitch(Point(player.home.x + shiftX + m_uniform->GetValue(-r, r),
+                                  player.home.y + shiftY + m_uniform->GetValue(-r, r)));
+    }
+
+    double MatchMobilityGenerator::NextSpeed ()
+    {
+        if (m_uniform->GetValue(0.0, 1.0) < m_config.sprintProbability) {
+            double speed = m_config.sprintSpeedMean
+                + m_config.sprintSpeedStdDev * m_normal->GetValue(0.0, 1.0);
+            return std::max(speed, m_config.jogSpeedMax);
+        }
+        return m_uniform->GetValue(m_config.jogSpeedMin, m_config.jogSpeedMax);
+    }
+
+    void MatchMobilityGenerator::AppendLeg (uint32_t playerIndex)
+    {
+        PlayerState& player = m_players[playerIndex];
+        Point target = NextTarget(player);
+        double distance = sqrt((target.x - player.lastTarget.x) * (target.x - player.lastTarget.x) +
+                               (target.y - player.lastTarget.y) * (target.y - player.lastTarget.y));
+        double duration = std::max(distance / NextSpeed(), 0.5);
+
+        player.lastTime += Seconds(duration);
+        player.lastTarget = target;
+        player.mobility->AddWaypoint(Waypoint(player.lastTime, Vector(target.x, target.y, 0.0)));
+    }
+
+    // Keeps one queued leg beyond the current one. Runs whenever a player reaches a waypoint
+    // and queues the leg after the one that just started.
+    void MatchMobilityGenerator::ExtendTrajectory (uint32_t playerIndex)
+    {
+        Time reached = m_players[playerIndex].lastTime;
+        AppendLeg(playerIndex);
+        Simulator::Schedule(reached - Simulator::Now(), &MatchMobilityGenerator::ExtendTrajectory, this, playerIndex);
+    }
+
+    void MatchMobilityGenerator::MoveFocus ()
+    {
+        m_focus = ClampToPitch(Point(m_focus.x + m_normal->GetValue(0.0, 100.0),
+                                     m_focus.y + m_normal->GetValue(0.0, 36.0)));
+        Simulator::Schedule(Seconds(m_config.focusInterval), &MatchMobilityGenerator::MoveFocus, this);
+    }
+
+    void MatchMobilityGenerator::Install (NodeContainer players)
+    {
+        uint32_t numPlayers = std::min(GetNumPlayers(), players.GetN());
+        m_players.clear();
+        m_players.reserve(numPlayers);
+
+        std::vector<Point> homes;
+        for (uint32_t i = 0; i < numPlayers; ++i) {
+            uint32_t team = i / m_config.teamSize;
+            if (i % m_config.teamSize == 0) {
+                homes = FormationHomes(team);
+            }
+
+            PlayerState player;
+            player.mobility = CreateObject<WaypointMobilityModel>();
+            player.home = homes[i % m_config.teamSize];
+            player.lastTarget = player.home;
+            player.lastTime = Seconds(0);
+            player.team = team;
+            players.Get(i)->AggregateObject(player.mobility);
+            player.mobility->AddWaypoint(Waypoint(Seconds(0), Vector(player.home.x, player.home.y, 0.0)));
+            m_players.push_back(player);
+
+            ExtendTrajectory(i);
+        }
+        NS_LOG_INFO("Generating trajectories for " << numPlayers << " players");
+
+        Simulator::Schedule(Seconds(m_config.focusInterval), &MatchMobilityGenerator::MoveFocus, this);
+    }
+
+} // namespace ns3
@@ -0,0 +1,79 @@
+#ifndef MATCH_MOBILITY_GENERATOR_H
+#define MATCH_MOBILITY_GENERATOR_H
+#include "utilities.h"
+#include "ns3/object.h"
+#include "ns3/node-container.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/waypoint-mobility-model.h"
+
+#include <string>
+#include <vector>
+
+using namespace ns3;
+namespace ns3
+{
+    // Parameters of a synthetic match. Defaults describe two 4-4-2 teams on a 122x90 pitch.
+    struct MatchMobilityConfig
+    {
+        uint32_t numTeams = 2;
+        uint32_t teamSize = 11;
+        std::string formation = "4-4-2";
+        double xBound = 122.0;
+        double yBound = 90.0;
+        // Probability that a leg is run as a sprint instead of a jog
+        double sprintProbability = 0.1;
+        double sprintSpeedMean = 7.0;
+        double sprintSpeedStdDev = 1.0;
+        double jogSpeedMin = 1.0;
+        double jogSpeedMax = 4.0;
+        // Random offset around the tactical target of each leg
+        double jitterRadius = 8.0;
+        // How often the ball focus of the match moves
+        double focusInterval = 2.0;
+    };
+
+    // Generates football player trajectories on the fly. Each node gets a WaypointMobilityModel
+    // that only ever holds the current leg and the next one; new legs are appended as
+    // simulation time advances, so memory stays constant in the match length.
+    class MatchMobilityGenerator : public Object
+    {
+        private:
+            struct PlayerState
+            {
+                Ptr<WaypointMobilityModel> mobility;
+                Point home;
+                Point lastTarget;
+                Time lastTime;
+                uint32_t team;
+            };
+
+            MatchMobilityConfig m_config;
+            std::vector<PlayerState> m_players;
+            Point m_focus;
+            Ptr<UniformRandomVariable> m_uniform;
+            Ptr<NormalRandomVariable> m_normal;
+
+            std::vector<uint32_t> ParseFormation () const;
+            std::vector<Point> FormationHomes (uint32_t team) const;
+            Point ClampToPitch (Point p) const;
+            Point NextTarget (const PlayerState& player);
+            double NextSpeed ();
+            void AppendLeg (uint32_t playerIndex);
+            void ExtendTrajectory (uint32_t playerIndex);
+            void MoveFocus ();
+
+        public:
+            MatchMobilityGenerator ();
+            ~MatchMobilityGenerator ();
+            static TypeId GetTypeId ();
+
+            void Setup (const MatchMobilityConfig& config);
+            // Installs mobility on numTeams * teamSize nodes, in team order
+            void Install (NodeContainer players);
+            int64_t AssignStreams (int64_t stream);
+            uint32_t GetNumPlayers () const;
+    };
+
+} // namespace ns3
+
+#endif
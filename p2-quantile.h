@@ -0,0 +1,99 @@
+#ifndef P2_QUANTILE_H
+#define P2_QUANTILE_H
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+
+namespace ns3
+{
+    // Streaming quantile estimate in constant memory, using the P-square algorithm of
+    // Jain and Chlamtac: five markers whose heights are adjusted with piecewise parabolic
+    // interpolation as observations arrive.
+    class P2Quantile
+    {
+        public:
+            explicit P2Quantile(double p = 0.5) : m_p(p), m_count(0) {}
+
+            void Add(double x) {
+                if (m_count < 5) {
+                    m_q[m_count++] = x;
+                    if (m_count == 5) {
+                        std::sort(m_q.begin(), m_q.end());
+                        m_n = {0, 1, 2, 3, 4};
+                        m_np = {0, 2 * m_p, 4 * m_p, 2 + 2 * m_p, 4};
+                        m_dn = {0, m_p / 2, m_p, (1 + m_p) / 2, 1};
+                    }
+                    return;
+                }
+
+                int k;
+                if (x < m_q[0]) {
+                    m_q[0] = x;
+                    k = 0;
+                } else if (x >= m_q[4]) {
+                    m_q[4] = x;
+                    k = 3;
+                } else {
+                    k = 0;
+                    while (x >= m_q[k + 1]) {
+                        ++k;
+                    }
+                }
+                for (int i = k + 1; i < 5; ++i) {
+                    m_n[i] += 1;
+                }
+                for (int i = 0; i < 5; ++i) {
+                    m_np[i] += m_dn[i];
+                }
+                m_count++;
+
+                for (int i = 1; i < 4; ++i) {
+                    double d = m_np[i] - m_n[i];
+                    if ((d >= 1 && m_n[i + 1] - m_n[i] > 1) || (d <= -1 && m_n[i - 1] - m_n[i] < -1)) {
+                        int s = d > 0 ? 1 : -1;
+                        double q = Parabolic(i, s);
+                        if (!(m_q[i - 1] < q && q < m_q[i + 1])) {
+                            q = m_q[i] + s * (m_q[i + s] - m_q[i]) / (m_n[i + s] - m_n[i]);
+                        }
+                        m_q[i] = q;
+                        m_n[i] += s;
+                    }
+                }
+            }
+
+            // Current estimate, exact while fewer than five observations have been seen
+            double Get() const {
+                if (m_count == 0) {
+                    return 0.0;
+                }
+                if (m_count < 5) {
+                    std::array<double, 5> sorted = m_q;
+                    std::sort(sorted.begin(), sorted.begin() + m_count);
+                    return sorted[static_cast<uint32_t>(std::floor(m_p * (m_count - 1)))];
+                }
+                return m_q[2];
+            }
+
+            uint64_t GetCount() const { return m_count; }
+
+        private:
+            double Parabolic(int i, int s) const {
+                return m_q[i] + s / (m_n[i + 1] - m_n[i - 1])
+                    * ((m_n[i] - m_n[i - 1] + s) * (m_q[i + 1] - m_q[i]) / (m_n[i + 1] - m_n[i])
+                     + (m_n[i + 1] - m_n[i] - s) * (m_q[i] - m_q[i - 1]) / (m_n[i] - m_n[i - 1]));
+            }
+
+            double m_p;
+            uint64_t m_count;
+            // Marker heights, actual and desired positions, and desired position increments
+            std::array<double, 5> m_q;
+            std::array<double, 5> m_n;
+            std::array<double, 5> m_np;
+            std::array<double, 5> m_dn;
+    };
+
+} // namespace ns3
+
+#endif
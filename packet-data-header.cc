@@ -1,19 +1,34 @@
 #include "packet-data-header.h"
 
+#include <cstring>
+
+// Doubles travel as their IEEE 754 bit pattern in network byte order
+static uint64_t DoubleToBits(double value) {
+  uint64_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+static double BitsToDouble(uint64_t bits) {
+  double value;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
 // Serialize
 void PacketDataHeader::Serialize(ns3::Buffer::Iterator start) const {
   start.WriteHtonU32(m_packetType);
-  start.WriteHtonU64(*reinterpret_cast<const uint64_t*>(&m_xCoord));
-  start.WriteHtonU64(*reinterpret_cast<const uint64_t*>(&m_yCoord));
-  start.WriteHtonU64(*reinterpret_cast<const uint64_t*>(&m_batteryLevel));
+  start.WriteHtonU64(DoubleToBits(m_xCoord));
+  start.WriteHtonU64(DoubleToBits(m_yCoord));
+  start.WriteHtonU64(DoubleToBits(m_batteryLevel));
 }
 
 // Deserialize
 uint32_t PacketDataHeader::Deserialize(ns3::Buffer::Iterator start) {
   m_packetType = start.ReadNtohU32();
-  m_xCoord = *reinterpret_cast<const double*>(start.ReadNtohU64());
-  m_yCoord = *reinterpret_cast<const double*>(start.ReadNtohU64());
-  m_batteryLevel = *reinterpret_cast<const double*>(start.ReadNtohU64());
+  m_xCoord = BitsToDouble(start.ReadNtohU64());
+  m_yCoord = BitsToDouble(start.ReadNtohU64());
+  m_batteryLevel = BitsToDouble(start.ReadNtohU64());
   return GetSerializedSize();
 }
 
@@ -0,0 +1,159 @@
+#include "ns3/log.h"
+#include "radio-backend.h"
+#include "ns3/simulator.h"
+#include "ns3/double.h"
+#include "ns3/wifi-module.h"
+#include "ns3/yans-wifi-channel.h"
+#include "ns3/yans-wifi-helper.h"
+#include "ns3/propagation-loss-model.h"
+#include "ns3/propagation-delay-model.h"
+
+namespace ns3
+{
+    NS_LOG_COMPONENT_DEFINE("RadioBackend");
+    NS_OBJECT_ENSURE_REGISTERED(RadioBackend);
+
+    // CC2420-class transceiver at 3 V, used for LR-WPAN energy accounting
+    static const double LRWPAN_VOLTAGE = 3.0;
+    static const double LRWPAN_TX_CURRENT_A = 0.0174;
+    static const double LRWPAN_RX_CURRENT_A = 0.0188;
+    static const double LRWPAN_IDLE_CURRENT_A = 0.000426;
+
+    TypeId RadioBackend::GetTypeId()
+    {
+        static TypeId tid = TypeId("ns3::RadioBackend")
+            .AddConstructor<RadioBackend>()
+            .SetParent<Object>();
+        return tid;
+    }
+
+    RadioBackend::RadioBackend () : m_radioType(RADIO_WIFI), m_lrWpanEnergy(0.0) {}
+
+    RadioBackend::~RadioBackend () {}
+
+    bool RadioBackend::ParseRadioType (const std::string& name, RadioType& radioType)
+    {
+        if (name == "wifi") {
+            radioType = RADIO_WIFI;
+            return true;
+        }
+        if (name == "lrwpan") {
+            radioType = RADIO_LRWPAN;
+            return true;
+        }
+        return false;
+    }
+
+    void RadioBackend::Setup (RadioType radioType)
+    {
+        m_radioType = radioType;
+    }
+
+    RadioType RadioBackend::GetRadioType () const
+    {
+        return m_radioType;
+    }
+
+    NetDeviceContainer RadioBackend::Install (NodeContainer nodes)
+    {
+        if (m_radioType == RADIO_LRWPAN) {
+            // The helper creates a single spectrum channel with log distance loss
+            LrWpanHelper lrWpanHelper;
+            NetDeviceContainer lrWpanDevices = lrWpanHelper.Install(nodes);
+            lrWpanHelper.AssociateToPan(lrWpanDevices, 10);
+            return lrWpanDevices;
+        }
+
+        // Creating a wifi channel between all the nodes(Sinks+players)
+        WifiHelper wifi;
+        wifi.SetStandard(WIFI_STANDARD_80211ax);
+
+        YansWifiPhyHelper wifiPhy;
+
+        Ptr<YansWifiChannel> wifiChannel = CreateObject<YansWifiChannel>();
+        Ptr<LogDistancePropagationLossModel> lossModel =
+            CreateObject<LogDistancePropagationLossModel>();
+        Ptr<ConstantSpeedPropagationDelayModel> delayModel = CreateObject<ConstantSpeedPropagationDelayModel>();
+
+        wifiChannel->SetPropagationDelayModel(delayModel);
+        wifiChannel->SetPropagationLossModel(lossModel);
+
+        wifiPhy.SetChannel(wifiChannel);
+
+        WifiMacHelper wifiMac;
+        wifi.SetRemoteStationManager("ns3::ConstantRateWifiManager");
+        // Set it to adhoc mode, with QoS so that tag classes map onto access categories
+        wifiMac.SetType("ns3::AdhocWifiMac", "QosSupported", BooleanValue(true));
+
+        return wifi.Install(wifiPhy, wifiMac, nodes);
+    }
+
+    // Wi-Fi uses the stock radio energy model. LR-WPAN has none, so the transceiver state
+    // changes are integrated against typical 802.15.4 currents instead.
+    void RadioBackend::MeterEnergy (NetDeviceContainer devices)
+    {
+        if (m_radioType == RADIO_WIFI) {
+            NodeContainer nodes;
+            for (uint32_t i = 0; i < devices.GetN(); ++i) {
+                nodes.Add(devices.Get(i)->GetNode());
+            }
+            BasicEnergySourceHelper sourceHelper;
+            // Large enough that no tag runs flat during a match
+            sourceHelper.Set("BasicEnergySourceInitialEnergyJ", DoubleValue(1e6));
+            EnergySourceContainer sources = sourceHelper.Install(nodes);
+            WifiRadioEnergyModelHelper radioEnergyHelper;
+            m_wifiEnergyModels = radioEnergyHelper.Install(devices, sources);
+            return;
+        }
+
+        m_lrWpanStates.assign(devices.GetN(), {IEEE_802_15_4_PHY_TRX_OFF, Simulator::Now()});
+        for (uint32_t i = 0; i < devices.GetN(); ++i) {
+            Ptr<LrWpanNetDevice> device = DynamicCast<LrWpanNetDevice>(devices.Get(i));
+            device->GetPhy()->TraceConnect("TrxState", std::to_string(i),
+                MakeCallback(&RadioBackend::LrWpanStateChange, this));
+        }
+    }
+
+    double RadioBackend::LrWpanPower (LrWpanPhyEnumeration state) const
+    {
+        switch (state)
+        {
+            case IEEE_802_15_4_PHY_BUSY_TX:
+            case IEEE_802_15_4_PHY_TX_ON:
+                return LRWPAN_VOLTAGE * LRWPAN_TX_CURRENT_A;
+            case IEEE_802_15_4_PHY_BUSY_RX:
+            case IEEE_802_15_4_PHY_RX_ON:
+            case IEEE_802_15_4_PHY_BUSY:
+                return LRWPAN_VOLTAGE * LRWPAN_RX_CURRENT_A;
+            default:
+                return LRWPAN_VOLTAGE * LRWPAN_IDLE_CURRENT_A;
+        }
+    }
+
+    void RadioBackend::LrWpanStateChange (std::string context, Time time, LrWpanPhyEnumeration oldState, LrWpanPhyEnumeration newState)
+    {
+        LrWpanState& device = m_lrWpanStates[std::stoul(context)];
+        m_lrWpanEnergy += LrWpanPower(device.state) * (time - device.since).GetSeconds();
+        device.state = newState;
+        device.since = time;
+    }
+
+    double RadioBackend::GetTotalEnergy () const
+    {
+        double total = 0.0;
+        if (m_radioType == RADIO_WIFI) {
+            for (auto it = m_wifiEnergyModels.Begin(); it != m_wifiEnergyModels.End(); ++it) {
+                total += (*it)->GetTotalEnergyConsumption();
+            }
+            return total;
+        }
+
+        total = m_lrWpanEnergy;
+        Time now = Simulator::Now();
+        for (const LrWpanState& device : m_lrWpanStates) {
+            total += LrWpanPower(device.state) * (now - device.since).GetSeconds();
+        }
+        return total;
+    }
+
+} // namespace ns3
@@ -0,0 +1,58 @@
+#ifndef RADIO_BACKEND_H
+#define RADIO_BACKEND_H
+#include "ns3/object.h"
+#include "ns3/node-container.h"
+#include "ns3/net-device-container.h"
+#include "ns3/energy-module.h"
+#include "ns3/lr-wpan-module.h"
+
+#include <string>
+#include <vector>
+
+using namespace ns3;
+namespace ns3
+{
+    enum RadioType {
+        RADIO_WIFI = 0,
+        RADIO_LRWPAN = 1
+    };
+
+    // Installs the tag radio stack, 802.11ax ad hoc or IEEE 802.15.4, behind one setup path.
+    // The returned devices are the ones 6LoWPAN is installed on. Also meters the energy the
+    // tag radios spend, so runs with different radios can be compared per fix.
+    class RadioBackend : public Object
+    {
+        private:
+            // Transceiver state of one LR-WPAN device since the last state change
+            struct LrWpanState
+            {
+                LrWpanPhyEnumeration state;
+                Time since;
+            };
+
+            RadioType m_radioType;
+            DeviceEnergyModelContainer m_wifiEnergyModels;
+            std::vector<LrWpanState> m_lrWpanStates;
+            double m_lrWpanEnergy;
+
+            double LrWpanPower (LrWpanPhyEnumeration state) const;
+            void LrWpanStateChange (std::string context, Time time, LrWpanPhyEnumeration oldState, LrWpanPhyEnumeration newState);
+
+        public:
+            RadioBackend ();
+            ~RadioBackend ();
+            static TypeId GetTypeId ();
+            // "wifi" or "lrwpan"
+            static bool ParseRadioType (const std::string& name, RadioType& radioType);
+
+            void Setup (RadioType radioType);
+            NetDeviceContainer Install (NodeContainer nodes);
+            void MeterEnergy (NetDeviceContainer devices);
+            // Energy consumed by the metered devices so far, in joules
+            double GetTotalEnergy () const;
+            RadioType GetRadioType () const;
+    };
+
+} // namespace ns3
+
+#endif
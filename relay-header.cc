@@ -0,0 +1,46 @@
+#include "relay-header.h"
+
+// Serialize
+void RelayHeader::Serialize(ns3::Buffer::Iterator start) const {
+  start.WriteHtonU32(m_originId);
+  start.WriteHtonU32(m_sequence);
+  start.WriteU8(m_hopCount);
+  start.WriteU8(m_anchorIndex);
+  start.WriteU8(m_priority);
+  start.WriteHtonU64(static_cast<uint64_t>(m_generatedAtNs));
+}
+
+// Deserialize
+uint32_t RelayHeader::Deserialize(ns3::Buffer::Iterator start) {
+  m_originId = start.ReadNtohU32();
+  m_sequence = start.ReadNtohU32();
+  m_hopCount = start.ReadU8();
+  m_anchorIndex = start.ReadU8();
+  m_priority = start.ReadU8();
+  m_generatedAtNs = static_cast<int64_t>(start.ReadNtohU64());
+  return GetSerializedSize();
+}
+
+// GetSerializedSize
+uint32_t RelayHeader::GetSerializedSize() const {
+  return sizeof(m_originId) + sizeof(m_sequence) + sizeof(m_hopCount) + sizeof(m_anchorIndex)
+    + sizeof(m_priority) + sizeof(m_generatedAtNs);
+}
+
+// Print
+void RelayHeader::Print(std::ostream &os) const {
+  os << "Origin: " << m_originId << ", Sequence: " << m_sequence << ", Hops: " << (int)m_hopCount << ", Anchor: " << (int)m_anchorIndex;
+}
+
+// TypeId
+ns3::TypeId RelayHeader::GetTypeId(void) {
+  static ns3::TypeId tid = ns3::TypeId("RelayHeader")
+    .SetParent<Header>()
+    .AddConstructor<RelayHeader>();
+  return tid;
+}
+
+ns3::TypeId RelayHeader::GetInstanceTypeId(void) const
+{
+  return GetTypeId();
+}
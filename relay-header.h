@@ -0,0 +1,53 @@
+#pragma once
+
+#include "ns3/header.h"
+#include "ns3/nstime.h"
+
+// Carried inside a LOCATION_RELAY packet, identifies the original response while it is
+// forwarded hop by hop towards an anchor
+class RelayHeader : public ns3::Header
+{
+    public:
+        RelayHeader() : m_originId(0), m_sequence(0), m_hopCount(0), m_anchorIndex(0), m_priority(0), m_generatedAtNs(0) {}
+        virtual ~RelayHeader() {}
+
+        // Node id of the tag that produced the fix
+        void SetOriginId(uint32_t originId) { m_originId = originId; }
+        uint32_t GetOriginId() const { return m_originId; }
+
+        void SetSequence(uint32_t sequence) { m_sequence = sequence; }
+        uint32_t GetSequence() const { return m_sequence; }
+
+        void SetHopCount(uint8_t hopCount) { m_hopCount = hopCount; }
+        uint8_t GetHopCount() const { return m_hopCount; }
+
+        // Index of the anchor that requested the fix and that it is routed to, as added with AddTransmitter
+        void SetAnchorIndex(uint8_t anchorIndex) { m_anchorIndex = anchorIndex; }
+        uint8_t GetAnchorIndex() const { return m_anchorIndex; }
+
+        // Socket priority of the origin tag's class, kept on every hop
+        void SetPriority(uint8_t priority) { m_priority = priority; }
+        uint8_t GetPriority() const { return m_priority; }
+
+        // Simulation time the origin tag computed the fix at
+        void SetGeneratedAt(ns3::Time generatedAt) { m_generatedAtNs = generatedAt.GetNanoSeconds(); }
+        ns3::Time GetGeneratedAt() const { return ns3::NanoSeconds(m_generatedAtNs); }
+
+        // NS3 Header methods
+        virtual void Serialize(ns3::Buffer::Iterator start) const;
+        virtual uint32_t Deserialize(ns3::Buffer::Iterator start);
+        virtual uint32_t GetSerializedSize() const;
+        virtual void Print(std::ostream &os) const;
+
+        // Needed for NS3 TypeId system
+        static ns3::TypeId GetTypeId(void);
+        virtual ns3::TypeId GetInstanceTypeId(void) const;
+
+    private:
+        uint32_t m_originId;
+        uint32_t m_sequence;
+        uint8_t m_hopCount;
+        uint8_t m_anchorIndex;
+        uint8_t m_priority;
+        int64_t m_generatedAtNs;
+};
@@ -0,0 +1,180 @@
+#!/usr/bin/env python3
+"""End-to-end scaling harness for the footsim program.
+
+Runs a matrix of deterministic synthetic-mobility scenarios against a built footsim
+binary, records wall-clock time, simulator events per second, peak RSS and packets
+per simulated second, and compares them against a stored JSON baseline.
+
+    ./ns3 build SportsSim
+    python3 scratch/SportsSim/scaling-harness.py \\
+        --binary build/scratch/SportsSim/ns3.40-SportsSim-default
+
+Exits with status 1 when any metric crosses its threshold and with status 2 when a
+scenario has no recorded baseline, so an unrecorded baseline cannot pass silently. Use
+--update-baseline to record the current results as the new baseline.
+"""
+
+import argparse
+import json
+import os
+import platform
+import subprocess
+import sys
+import tempfile
+import time
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+DEFAULT_BASELINE = os.path.join(HERE, "scaling-baseline.json")
+
+
+def scenario_args(scenario, duration, seed):
+    players = scenario["players"]
+    # Two teams whenever the count splits evenly, a single team otherwise
+    teams = 2 if players % 2 == 0 else 1
+    return [
+        "--mobility=synthetic",
+        "--teams=%d" % teams,
+        "--teamSize=%d" % (players // teams),
+        "--anchors=%d" % scenario["anchors"],
+        "--duration=%g" % duration,
+        "--seed=%d" % seed,
+        "--run=1",
+        "--anim=false",
+    ]
+
+
+def parse_stats(output):
+    for line in output.splitlines():
+        if line.startswith("footsim-stats "):
+            return dict(field.split("=", 1) for field in line.split()[1:])
+    return None
+
+
+def run_scenario(binary, scenario, duration, seed):
+    cmd = [binary] + scenario_args(scenario, duration, seed)
+    # stderr goes to a file so that neither pipe can fill up while stdout is read
+    with tempfile.TemporaryFile(mode="w+") as errors:
+        start = time.monotonic()
+        proc = subprocess.Popen(cmd, stdout=subprocess.PIPE, stderr=errors, text=True)
+        output = proc.stdout.read()
+        # wait4 gives the resource usage of this child only
+        _, status, usage = os.wait4(proc.pid, 0)
+        wall = time.monotonic() - start
+        proc.returncode = os.waitstatus_to_exitcode(status)
+        errors.seek(0)
+        stderr = errors.read()
+    if proc.returncode != 0:
+        raise RuntimeError("%s exited with %d\n%s" % (" ".join(cmd), proc.returncode, stderr.rstrip()))
+
+    stats = parse_stats(output)
+    if stats is None:
+        raise RuntimeError("%s printed no footsim-stats line\n%s" % (" ".join(cmd), stderr.rstrip()))
+    sim_seconds = float(stats["simSeconds"])
+    return {
+        "wall_seconds": wall,
+        "events_per_second": int(stats["events"]) / wall if wall > 0 else 0.0,
+        # ru_maxrss is in kilobytes on Linux
+        "peak_rss_mb": usage.ru_maxrss / 1024.0,
+        "packets_per_sim_second": int(stats["packets"]) / sim_seconds if sim_seconds > 0 else 0.0,
+    }
+
+
+def describe_machine():
+    """Identifies the machine a baseline was recorded on, wall-clock figures only compare there."""
+    cpu = platform.processor()
+    try:
+        with open("/proc/cpuinfo") as f:
+            for line in f:
+                if line.startswith("model name"):
+                    cpu = line.split(":", 1)[1].strip()
+                    break
+    except OSError:
+        pass
+    return {
+        "host": platform.node(),
+        "cpu": cpu,
+        "cpus": os.cpu_count(),
+        "os": platform.platform(),
+        "python": platform.python_version(),
+    }
+
+
+def compare(name, current, baseline, thresholds):
+    """Returns the list of regressions of one scenario."""
+    failures = []
+    for metric, rule in thresholds.items():
+        if metric not in baseline or baseline[metric] is None:
+            continue
+        old = baseline[metric]
+        new = current[metric]
+        kind = rule["kind"]
+        limit = rule["ratio"]
+        if kind == "max" and new > old * limit:
+            failures.append("%s: %s %.3f > %.3f x baseline %.3f" % (name, metric, new, limit, old))
+        elif kind == "min" and new < old * limit:
+            failures.append("%s: %s %.3f < %.3f x baseline %.3f" % (name, metric, new, limit, old))
+        elif kind == "exact" and old > 0 and abs(new - old) / old > limit:
+            failures.append("%s: %s %.3f differs from baseline %.3f by more than %.0f%%"
+                            % (name, metric, new, old, limit * 100))
+    return failures
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--binary", required=True, help="built footsim executable")
+    parser.add_argument("--baseline", default=DEFAULT_BASELINE, help="baseline JSON file")
+    parser.add_argument("--update-baseline", action="store_true", help="store the results as the new baseline")
+    parser.add_argument("--only", action="append", default=[], help="run only the named scenario (repeatable)")
+    parser.add_argument("--output", help="write the results of this run as JSON")
+    args = parser.parse_args()
+
+    with open(args.baseline) as f:
+        baseline = json.load(f)
+
+    duration = baseline["duration"]
+    seed = baseline["seed"]
+    machine = describe_machine()
+    recorded_on = baseline.get("machine")
+    if recorded_on and not args.update_baseline and recorded_on.get("host") != machine["host"]:
+        print("WARNING baseline was recorded on %s (%s), this is %s (%s); time and RSS figures do not compare"
+              % (recorded_on.get("host"), recorded_on.get("cpu"), machine["host"], machine["cpu"]))
+    results = {}
+    failures = []
+    missing = []
+    for name, scenario in baseline["scenarios"].items():
+        if args.only and name not in args.only:
+            continue
+        current = run_scenario(args.binary, scenario, duration, seed)
+        results[name] = current
+        print("%-10s wall %8.2f s  events/s %12.0f  rss %8.1f MB  packets/sim-s %10.1f"
+              % (name, current["wall_seconds"], current["events_per_second"],
+                 current["peak_rss_mb"], current["packets_per_sim_second"]))
+        if scenario.get("metrics"):
+            failures += compare(name, current, scenario["metrics"], baseline["thresholds"])
+        else:
+            missing.append(name)
+
+    if args.output:
+        with open(args.output, "w") as f:
+            json.dump(results, f, indent=2)
+
+    if args.update_baseline:
+        for name, current in results.items():
+            baseline["scenarios"][name]["metrics"] = current
+        baseline["machine"] = machine
+        with open(args.baseline, "w") as f:
+            json.dump(baseline, f, indent=2)
+            f.write("\n")
+        return 0
+
+    for failure in failures:
+        print("REGRESSION " + failure)
+    for name in missing:
+        print("NO BASELINE %s, record one with --update-baseline" % name)
+    if failures:
+        return 1
+    return 2 if missing else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
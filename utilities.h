@@ -1,12 +1,43 @@
 #pragma once
 
+#include <cmath>
+
 enum PacketType {
     LOCATION_REQUEST = 1,
     INFO_REQUEST = 2,
     INFO_RESPONSE = 3,
-    LOCATION_RESPONSE = 4
+    LOCATION_RESPONSE = 4,
+    LOCATION_RELAY = 5
+};
+
+// Classes of tracked tags, in decreasing scheduling priority
+enum TagClass {
+    TAG_BALL = 0,
+    TAG_PLAYER = 1,
+    TAG_OFFICIAL = 2,
+    NUM_TAG_CLASSES = 3
+};
+
+struct TagClassProfile
+{
+    // Target update rate in fixes per second
+    double updateRate;
+    // Socket priority, mapped onto a Wi-Fi access category when QoS is enabled
+    unsigned char socketPriority;
 };
 
+// Ball at high rate on AC_VO, players at medium rate on AC_VI, officials at low rate on AC_BK
+inline TagClassProfile DefaultTagClassProfile(TagClass tagClass) {
+    switch (tagClass) {
+        case TAG_BALL:
+            return {20.0, 6};
+        case TAG_OFFICIAL:
+            return {1.0, 1};
+        default:
+            return {5.0, 5};
+    }
+}
+
 struct Point
 {
     double x;
@@ -18,6 +49,10 @@ struct Point
     Point () {}
 };
 
+inline double PointDistance(const Point& a, const Point& b) {
+    return sqrt((a.x - b.x) * (a.x - b.x) + (a.y - b.y) * (a.y - b.y));
+}
+
 struct PacketData {
     int packetType;
     double xCoord;